@@ -0,0 +1,1034 @@
+#define _GNU_SOURCE
+#include <nuconv.h>
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nuconv_bench.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef uint64_t (*bench_fn)(const void* arg);
+
+static size_t bench_count = 1u << 16;
+static double bench_min_time = 0.05;
+static bool bench_json = false;
+static const char* bench_filter = NULL;
+static volatile uint64_t bench_sink;
+/* Set during the untimed call whose checksum is printed, for cases that
+   only agree after extra work (such as parsing their output back). */
+static bool bench_checking = false;
+
+static uint64_t bench_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t bench_rand(void)
+{
+  bench_state ^= bench_state << 13;
+  bench_state ^= bench_state >> 7;
+  bench_state ^= bench_state << 17;
+  return bench_state;
+}
+
+static double bench_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void* bench_alloc(size_t n)
+{
+  void* p = malloc(n);
+  if (p == NULL) {
+    fputs("nuconv_bench: out of memory\n", stderr);
+    exit(1);
+  }
+  return p;
+}
+
+/* Cycle and branch-miss counters for this thread; perf_fd stays -1 when the
+   kernel refuses them (no Linux, perf_event_paranoid, containers). */
+static int perf_fd = -1;
+static int perf_fd2 = -1;
+
+static void perf_open(void)
+{
+#ifdef __linux__
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (perf_fd < 0) {
+    perf_fd = -1;
+    return;
+  }
+  attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+  attr.disabled = 0;
+  perf_fd2 = (int)syscall(SYS_perf_event_open, &attr, 0, -1, perf_fd, 0);
+  if (perf_fd2 < 0) {
+    close(perf_fd);
+    perf_fd = perf_fd2 = -1;
+  }
+#endif
+}
+
+static void perf_start(void)
+{
+#ifdef __linux__
+  if (perf_fd >= 0) {
+    ioctl(perf_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+static bool perf_stop(uint64_t* cycles, uint64_t* misses)
+{
+#ifdef __linux__
+  if (perf_fd >= 0) {
+    uint64_t buf[3];
+    ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(perf_fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf) && buf[0] == 2) {
+      *cycles = buf[1];
+      *misses = buf[2];
+      return true;
+    }
+  }
+#else
+  (void)cycles;
+  (void)misses;
+#endif
+  return false;
+}
+
+/* Runs fn until bench_min_time has elapsed and prints one record; ops and
+   bytes are the work done by a single call and the checksum is that of a
+   single untimed call made with bench_checking set, so it matches across
+   implementations of the same case. */
+static void bench_run(const char* group, const char* dataset, unsigned radix,
+                      const char* impl, bench_fn fn, const void* arg,
+                      size_t ops, size_t bytes)
+{
+  char name[128];
+  snprintf(name, sizeof(name), "%s/%s/%u/%s", group, dataset, radix, impl);
+  if (bench_filter != NULL && strstr(name, bench_filter) == NULL) {
+    return;
+  }
+
+  bench_checking = true;
+  double t = bench_now();
+  const uint64_t checksum = fn(arg);
+  t = bench_now() - t;
+  bench_checking = false;
+  size_t reps = 1;
+  if (t < bench_min_time * 1e9) {
+    reps = (size_t)(bench_min_time * 1e9 / (t > 1.0 ? t : 1.0)) + 1;
+  }
+
+  uint64_t cycles = 0;
+  uint64_t misses = 0;
+  uint64_t sum = 0;
+  perf_start();
+  t = bench_now();
+  for (size_t r = 0; r < reps; ++r) {
+    sum += fn(arg);
+  }
+  t = bench_now() - t;
+  const bool counted = perf_stop(&cycles, &misses);
+  bench_sink += sum;
+
+  const double n = (double)ops * (double)reps;
+  const double ns = t / n;
+  const double gbs = (double)bytes * (double)reps / t;
+  if (bench_json) {
+    printf("{\"group\":\"%s\",\"dataset\":\"%s\",\"radix\":%u,\"impl\":\"%s\","
+           "\"ns_per_op\":%.3f,\"gb_per_s\":%.3f,", group, dataset, radix, impl,
+           ns, gbs);
+    if (counted) {
+      printf("\"cycles_per_op\":%.3f,\"branch_misses_per_op\":%.4f,",
+             (double)cycles / n, (double)misses / n);
+    } else {
+      printf("\"cycles_per_op\":null,\"branch_misses_per_op\":null,");
+    }
+    printf("\"checksum\":\"%016" PRIx64 "\"}\n", checksum);
+  } else {
+    printf("%s,%s,%u,%s,%.3f,%.3f,", group, dataset, radix, impl, ns, gbs);
+    if (counted) {
+      printf("%.3f,%.4f,", (double)cycles / n, (double)misses / n);
+    } else {
+      printf(",,");
+    }
+    printf("%016" PRIx64 "\n", checksum);
+  }
+  fflush(stdout);
+}
+
+enum bench_kind {
+  BENCH_UNIFORM,
+  BENCH_SKEWED,
+  BENCH_INVALID
+};
+
+static const char* const bench_kind_names[] = {"uniform", "skewed", "invalid"};
+
+/* uniform: digit counts uniform over [1, max]; skewed: geometric, mostly one
+   or two digits; invalid: uniform with one in eight strings carrying a
+   character outside the radix. Every value fits in an int64_t. */
+static struct bench_strs bench_make_strs(enum bench_kind kind, unsigned radix,
+                                         bool sign)
+{
+  static const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  const size_t max = nuconv_utoa_len(INT64_MAX, radix) - 1;
+  struct bench_strs s;
+  s.buf = bench_alloc(bench_count * (max + 2));
+  s.off = bench_alloc(bench_count * sizeof(size_t));
+  s.len = bench_alloc(bench_count * sizeof(size_t));
+  s.count = bench_count;
+  s.bytes = 0;
+  s.radix = radix;
+
+  char* p = s.buf;
+  for (size_t i = 0; i < bench_count; ++i) {
+    size_t len;
+    if (kind == BENCH_SKEWED) {
+      len = 1 + (size_t)__builtin_ctzll(bench_rand() | (1ull << 63));
+      len = len < max ? len : max;
+    } else {
+      len = 1 + (size_t)(bench_rand() % max);
+    }
+    s.off[i] = (size_t)(p - s.buf);
+    char* q = p;
+    if (sign && (bench_rand() & 1) != 0) {
+      *q++ = '-';
+    }
+    q[0] = alphabet[1 + bench_rand() % (radix - 1)];
+    for (size_t j = 1; j < len; ++j) {
+      q[j] = alphabet[bench_rand() % radix];
+    }
+    if (kind == BENCH_INVALID && bench_rand() % 8 == 0) {
+      q[bench_rand() % len] = '!';
+    }
+    q[len] = '\0';
+    s.len[i] = (size_t)(q + len - p);
+    s.bytes += s.len[i];
+    p = q + len + 1;
+  }
+  return s;
+}
+
+static void bench_free_strs(struct bench_strs* s)
+{
+  free(s->buf);
+  free(s->off);
+  free(s->len);
+}
+
+static uint64_t bench_nuconv_atoi(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    int64_t v = 0;
+    nuconv_do_atoi(&v, s->buf + s->off[i], s->radix, 0);
+    sum += (uint64_t)v;
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_atoin(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    int64_t v = 0;
+    nuconv_do_atoin(&v, p, p + s->len[i], NULL, s->radix, 0);
+    sum += (uint64_t)v;
+  }
+  return sum;
+}
+
+static uint64_t bench_strtoll(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += (uint64_t)strtoll(s->buf + s->off[i], NULL, (int)s->radix);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_atou(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    uint64_t v = 0;
+    nuconv_do_atou(&v, s->buf + s->off[i], s->radix, 0);
+    sum += v;
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_atoun(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    uint64_t v = 0;
+    nuconv_do_atoun(&v, p, p + s->len[i], NULL, s->radix, 0);
+    sum += v;
+  }
+  return sum;
+}
+
+static uint64_t bench_strtoull(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += strtoull(s->buf + s->off[i], NULL, (int)s->radix);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_itoa(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const int64_t* vals = s->vals;
+  uint64_t sum = 0;
+  char out[72];
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += (uint64_t)nuconv_do_itoa(vals[i], out, s->radix, 0) + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_utoa(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const uint64_t* vals = s->vals;
+  uint64_t sum = 0;
+  char out[72];
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += (uint64_t)nuconv_do_utoa(vals[i], out, s->radix, 0) + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+static uint64_t bench_snprintf_i(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const int64_t* vals = s->vals;
+  uint64_t sum = 0;
+  char out[72];
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += (uint64_t)snprintf(out, sizeof(out), "%" PRId64, vals[i]) + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+static uint64_t bench_snprintf_u(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const uint64_t* vals = s->vals;
+  const char* fmt = s->radix == 8 ? "%" PRIo64 : s->radix == 16 ? "%" PRIx64 : "%" PRIu64;
+  uint64_t sum = 0;
+  char out[72];
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += (uint64_t)snprintf(out, sizeof(out), fmt, vals[i]) + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+static void bench_parse(enum bench_kind kind, unsigned radix)
+{
+  const char* dataset = bench_kind_names[kind];
+  struct bench_strs s = bench_make_strs(kind, radix, true);
+  bench_run("atoi", dataset, radix, "nuconv_do_atoi", bench_nuconv_atoi, &s, s.count, s.bytes);
+  bench_run("atoi", dataset, radix, "nuconv_do_atoin", bench_nuconv_atoin, &s, s.count, s.bytes);
+  bench_run("atoi", dataset, radix, "strtoll", bench_strtoll, &s, s.count, s.bytes);
+#ifdef NUCONV_BENCH_CXX
+  bench_run("atoi", dataset, radix, "from_chars", bench_from_chars_i, &s, s.count, s.bytes);
+  if (radix == 10 || radix == 16) {
+    bench_run("atoi", dataset, radix, "nuconv::parse", bench_hpp_parse_i, &s, s.count, s.bytes);
+  }
+#endif
+  bench_free_strs(&s);
+
+  s = bench_make_strs(kind, radix, false);
+  bench_run("atou", dataset, radix, "nuconv_do_atou", bench_nuconv_atou, &s, s.count, s.bytes);
+  bench_run("atou", dataset, radix, "nuconv_do_atoun", bench_nuconv_atoun, &s, s.count, s.bytes);
+  bench_run("atou", dataset, radix, "strtoull", bench_strtoull, &s, s.count, s.bytes);
+#ifdef NUCONV_BENCH_CXX
+  bench_run("atou", dataset, radix, "from_chars", bench_from_chars_u, &s, s.count, s.bytes);
+#endif
+  bench_free_strs(&s);
+}
+
+static void bench_format(enum bench_kind kind, unsigned radix)
+{
+  const char* dataset = bench_kind_names[kind];
+  struct bench_strs s = bench_make_strs(kind, radix, true);
+  int64_t* ivals = bench_alloc(s.count * sizeof(int64_t));
+  for (size_t i = 0; i < s.count; ++i) {
+    ivals[i] = strtoll(s.buf + s.off[i], NULL, (int)radix);
+  }
+  struct bench_vals v = {ivals, s.count, s.bytes, radix};
+  bench_run("itoa", dataset, radix, "nuconv_do_itoa", bench_nuconv_itoa, &v, v.count, v.bytes);
+  if (radix == 10) {
+    bench_run("itoa", dataset, radix, "snprintf", bench_snprintf_i, &v, v.count, v.bytes);
+  }
+#ifdef NUCONV_BENCH_CXX
+  bench_run("itoa", dataset, radix, "to_chars", bench_to_chars_i, &v, v.count, v.bytes);
+  if (radix == 10 || radix == 16) {
+    bench_run("itoa", dataset, radix, "nuconv::format", bench_hpp_format_i, &v, v.count, v.bytes);
+  }
+#endif
+  free(ivals);
+  bench_free_strs(&s);
+
+  s = bench_make_strs(kind, radix, false);
+  uint64_t* uvals = bench_alloc(s.count * sizeof(uint64_t));
+  for (size_t i = 0; i < s.count; ++i) {
+    uvals[i] = strtoull(s.buf + s.off[i], NULL, (int)radix);
+  }
+  v.vals = uvals;
+  v.bytes = s.bytes;
+  bench_run("utoa", dataset, radix, "nuconv_do_utoa", bench_nuconv_utoa, &v, v.count, v.bytes);
+  if (radix == 8 || radix == 10 || radix == 16) {
+    bench_run("utoa", dataset, radix, "snprintf", bench_snprintf_u, &v, v.count, v.bytes);
+  }
+#ifdef NUCONV_BENCH_CXX
+  bench_run("utoa", dataset, radix, "to_chars", bench_to_chars_u, &v, v.count, v.bytes);
+#endif
+  free(uvals);
+  bench_free_strs(&s);
+}
+
+/* The strings of a dataset joined by commas into one CSV row, parsed with
+   the bulk parsers; threads applies to the parallel form. */
+struct bench_bulk {
+  char* text;
+  size_t len;
+  int64_t* dst;
+  size_t count;
+  unsigned radix;
+  unsigned threads;
+};
+
+static uint64_t bench_bulk_sum(const struct bench_bulk* b, size_t count)
+{
+  uint64_t sum = 0;
+  for (size_t i = 0; i < count; ++i) {
+    sum += (uint64_t)b->dst[i];
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_atoi_bulk(const void* arg)
+{
+  const struct bench_bulk* b = arg;
+  size_t count = b->count;
+  nuconv_do_atoi_bulk(b->dst, NULL, &count, b->text, b->text + b->len, NULL,
+                      ",", b->radix, 0);
+  return bench_bulk_sum(b, count);
+}
+
+static uint64_t bench_nuconv_atoi_bulk_parallel(const void* arg)
+{
+  const struct bench_bulk* b = arg;
+  size_t count = b->count;
+  nuconv_do_atoi_bulk_parallel(b->dst, NULL, &count, b->text,
+                               b->text + b->len, NULL, ",", b->radix, 0,
+                               b->threads);
+  return bench_bulk_sum(b, count);
+}
+
+/* Sweeps the thread count of the parallel parser from 1 (which still pays
+   for splitting the input) to 8 and 0, one per online CPU. */
+static void bench_bulk(enum bench_kind kind, unsigned radix)
+{
+  const char* dataset = bench_kind_names[kind];
+  struct bench_strs s = bench_make_strs(kind, radix, true);
+  struct bench_bulk b;
+  b.text = bench_alloc(s.bytes + s.count);
+  b.len = 0;
+  for (size_t i = 0; i < s.count; ++i) {
+    memcpy(b.text + b.len, s.buf + s.off[i], s.len[i]);
+    b.len += s.len[i];
+    b.text[b.len++] = ',';
+  }
+  b.dst = bench_alloc(s.count * sizeof(int64_t));
+  b.count = s.count;
+  b.radix = radix;
+  b.threads = 1;
+  bench_run("atoi_bulk", dataset, radix, "nuconv_do_atoi_bulk", bench_nuconv_atoi_bulk, &b, b.count, b.len);
+  static const unsigned threads[] = {1, 2, 4, 8, 0};
+  for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+    char impl[64];
+    snprintf(impl, sizeof(impl), "nuconv_do_atoi_bulk_parallel/%u", threads[i]);
+    b.threads = threads[i];
+    bench_run("atoi_bulk", dataset, radix, impl, bench_nuconv_atoi_bulk_parallel, &b, b.count, b.len);
+  }
+  free(b.text);
+  free(b.dst);
+  bench_free_strs(&s);
+}
+
+static uint64_t bench_nuconv_atod(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    double v = 0.0;
+    nuconv_do_atod(&v, p, p + s->len[i], NULL, 0);
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    sum += bits;
+  }
+  return sum;
+}
+
+static uint64_t bench_strtod(const void* arg)
+{
+  const struct bench_strs* s = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const double v = strtod(s->buf + s->off[i], NULL);
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    sum += bits;
+  }
+  return sum;
+}
+
+/* The shortest and the 17-digit forms differ in text and length, so the
+   printed checksum adds up the bits of each output parsed back instead. */
+static uint64_t bench_double_bits(const char* out)
+{
+  const double v = strtod(out, NULL);
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+static uint64_t bench_nuconv_dtoa(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const double* vals = s->vals;
+  uint64_t sum = 0;
+  char out[NUCONV_DTOA_BUFSIZE];
+  for (size_t i = 0; i < s->count; ++i) {
+    const int n = nuconv_do_dtoa(vals[i], out, 0);
+    sum += bench_checking ? bench_double_bits(out)
+                          : (uint64_t)n + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+static uint64_t bench_snprintf_d(const void* arg)
+{
+  const struct bench_vals* s = arg;
+  const double* vals = s->vals;
+  uint64_t sum = 0;
+  char out[40];
+  for (size_t i = 0; i < s->count; ++i) {
+    const int n = snprintf(out, sizeof(out), "%.17g", vals[i]);
+    sum += bench_checking ? bench_double_bits(out)
+                          : (uint64_t)n + (unsigned char)out[0];
+  }
+  return sum;
+}
+
+/* uniform: random finite bit patterns, printed with 17 digits; skewed:
+   short decimals such as prices, 1-4 fractional digits. */
+static void bench_float(enum bench_kind kind)
+{
+  const char* dataset = bench_kind_names[kind];
+  struct bench_strs s;
+  s.buf = bench_alloc(bench_count * NUCONV_DTOA_BUFSIZE);
+  s.off = bench_alloc(bench_count * sizeof(size_t));
+  s.len = bench_alloc(bench_count * sizeof(size_t));
+  s.count = bench_count;
+  s.bytes = 0;
+  s.radix = 10;
+  double* vals = bench_alloc(bench_count * sizeof(double));
+  char* p = s.buf;
+  for (size_t i = 0; i < bench_count; ++i) {
+    int len;
+    if (kind == BENCH_SKEWED) {
+      const unsigned frac = 1 + (unsigned)(bench_rand() % 4);
+      len = snprintf(p, NUCONV_DTOA_BUFSIZE, "%.*f", frac,
+                     (double)(bench_rand() % 100000000) / 1000.0);
+    } else {
+      uint64_t bits;
+      do {
+        bits = bench_rand();
+      } while ((bits >> 52 & 0x7FF) == 0x7FF);
+      memcpy(&vals[i], &bits, sizeof(bits));
+      len = snprintf(p, NUCONV_DTOA_BUFSIZE, "%.17g", vals[i]);
+    }
+    vals[i] = strtod(p, NULL);
+    s.off[i] = (size_t)(p - s.buf);
+    s.len[i] = (size_t)len;
+    s.bytes += (size_t)len;
+    p += len + 1;
+  }
+  bench_run("atod", dataset, 10, "nuconv_do_atod", bench_nuconv_atod, &s, s.count, s.bytes);
+  bench_run("atod", dataset, 10, "strtod", bench_strtod, &s, s.count, s.bytes);
+
+  struct bench_vals v = {vals, s.count, s.bytes, 10};
+  bench_run("dtoa", dataset, 10, "nuconv_do_dtoa", bench_nuconv_dtoa, &v, v.count, v.bytes);
+  bench_run("dtoa", dataset, 10, "snprintf", bench_snprintf_d, &v, v.count, v.bytes);
+  free(vals);
+  bench_free_strs(&s);
+}
+
+/* A haystack of lowercase letters with a distinct tail, so searches scan the
+   whole buffer before matching. */
+struct bench_mem {
+  char* a;
+  char* b;
+  size_t n;
+  size_t reps;
+};
+
+#define BENCH_NEEDLE 8
+
+/* Hides p from the optimizer so pure libc calls are not hoisted out of the
+   repetition loops. */
+#define BENCH_OPAQUE(p) __asm__ volatile("" : "+r"(p))
+
+static uint64_t bench_nuconv_memchr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)((char*)nuconv_memchr(a, 'Z', m->n) - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_memchr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)((char*)memchr(a, 'Z', m->n) - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_memcmp(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)nuconv_memcmp(a, m->b, m->n);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_memcmp(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)memcmp(a, m->b, m->n);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_memcpy(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    nuconv_memcpy(m->b, a, m->n);
+    sum += (unsigned char)m->b[r % m->n];
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_memcpy(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    memcpy(m->b, a, m->n);
+    sum += (unsigned char)m->b[r % m->n];
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_memmem(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  const char* needle = m->a + m->n - BENCH_NEEDLE;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)((char*)nuconv_memmem(a, m->n, needle, BENCH_NEEDLE) - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_memmem(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  const char* needle = m->a + m->n - BENCH_NEEDLE;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)((char*)memmem(a, m->n, needle, BENCH_NEEDLE) - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_memrev(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += nuconv_memrev(m->b, m->n) + (unsigned char)m->b[0];
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_strlen(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += nuconv_strlen(a);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_strlen(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += strlen(a);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_strchr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)(nuconv_strchr(a, 'Z') - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_strchr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)(strchr(a, 'Z') - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_strstr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  const char* needle = m->a + m->n - BENCH_NEEDLE;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)(nuconv_strstr(a, needle) - a);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_strstr(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  const char* needle = m->a + m->n - BENCH_NEEDLE;
+  uint64_t sum = 0;
+  for (size_t r = 0; r < m->reps; ++r) {
+    const char* a = m->a;
+    BENCH_OPAQUE(a);
+    sum += (uint64_t)(strstr(a, needle) - a);
+  }
+  return sum;
+}
+
+static void bench_memory(size_t n)
+{
+  struct bench_mem m;
+  m.a = bench_alloc(n + 1);
+  m.b = bench_alloc(n + 1);
+  m.n = n;
+  m.reps = (1u << 22) / n;
+  for (size_t i = 0; i < n; ++i) {
+    m.a[i] = (char)('a' + bench_rand() % 26);
+  }
+  for (size_t i = n - BENCH_NEEDLE; i < n; ++i) {
+    m.a[i] = (char)('A' + (i % 26));
+  }
+  m.a[n - 1] = 'Z';
+  m.a[n] = '\0';
+  memcpy(m.b, m.a, n + 1);
+
+  char dataset[32];
+  snprintf(dataset, sizeof(dataset), "%zu", n);
+  const size_t bytes = n * m.reps;
+  static const struct {
+    const char* group;
+    const char* impl;
+    bench_fn fn;
+  } cases[] = {
+    {"memchr", "nuconv", bench_nuconv_memchr},
+    {"memchr", "libc", bench_libc_memchr},
+    {"memcmp", "nuconv", bench_nuconv_memcmp},
+    {"memcmp", "libc", bench_libc_memcmp},
+    {"memcpy", "nuconv", bench_nuconv_memcpy},
+    {"memcpy", "libc", bench_libc_memcpy},
+    {"memmem", "nuconv", bench_nuconv_memmem},
+    {"memmem", "libc", bench_libc_memmem},
+    {"memrev", "nuconv", bench_nuconv_memrev},
+    {"strlen", "nuconv", bench_nuconv_strlen},
+    {"strlen", "libc", bench_libc_strlen},
+    {"strchr", "nuconv", bench_nuconv_strchr},
+    {"strchr", "libc", bench_libc_strchr},
+    {"strstr", "nuconv", bench_nuconv_strstr},
+    {"strstr", "libc", bench_libc_strstr},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    bench_run(cases[i].group, dataset, 0, cases[i].impl, cases[i].fn, &m, m.reps, bytes);
+  }
+  free(m.a);
+  free(m.b);
+}
+
+static uint64_t bench_nuconv_isdigit(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n; ++i) {
+    sum += (uint64_t)nuconv_isdigit(m->a[i]);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_isdigit_call(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  int (*volatile fn)(int) = (nuconv_isdigit);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n; ++i) {
+    sum += (uint64_t)fn(m->a[i]);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_isdigit(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n; ++i) {
+    sum += (uint64_t)(isdigit((unsigned char)m->a[i]) != 0);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_isspace(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n; ++i) {
+    sum += (uint64_t)nuconv_isspace(m->a[i]);
+  }
+  return sum;
+}
+
+static uint64_t bench_libc_isspace(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n; ++i) {
+    sum += (uint64_t)(isspace((unsigned char)m->a[i]) != 0);
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_memcspn(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < m->n;) {
+    const size_t k = nuconv_memcspn(m->a + i, m->n - i, NUCONV_DIGIT);
+    sum += k;
+    i += k + 1;
+  }
+  return sum;
+}
+
+static uint64_t bench_nuconv_tolower(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  for (size_t i = 0; i < m->n; ++i) {
+    m->b[i] = (char)nuconv_tolower((unsigned char)m->a[i]);
+  }
+  return (unsigned char)m->b[m->n / 2];
+}
+
+static uint64_t bench_libc_tolower(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  for (size_t i = 0; i < m->n; ++i) {
+    m->b[i] = (char)tolower((unsigned char)m->a[i]);
+  }
+  return (unsigned char)m->b[m->n / 2];
+}
+
+static uint64_t bench_nuconv_memcpy_lower(const void* arg)
+{
+  const struct bench_mem* m = arg;
+  nuconv_memcpy_lower(m->b, m->a, m->n);
+  return (unsigned char)m->b[m->n / 2];
+}
+
+static void bench_ctype(void)
+{
+  struct bench_mem m;
+  m.n = 1u << 16;
+  m.a = bench_alloc(m.n);
+  m.b = bench_alloc(m.n);
+  m.reps = 1;
+  for (size_t i = 0; i < m.n; ++i) {
+    m.a[i] = (char)(bench_rand() % 128);
+  }
+
+  static const struct {
+    const char* group;
+    const char* impl;
+    bench_fn fn;
+  } cases[] = {
+    {"isdigit", "nuconv", bench_nuconv_isdigit},
+    {"isdigit", "nuconv_call", bench_nuconv_isdigit_call},
+    {"isdigit", "libc", bench_libc_isdigit},
+    {"isspace", "nuconv", bench_nuconv_isspace},
+    {"isspace", "libc", bench_libc_isspace},
+    {"cspn_digit", "nuconv_memcspn", bench_nuconv_memcspn},
+    {"tolower", "nuconv", bench_nuconv_tolower},
+    {"tolower", "libc", bench_libc_tolower},
+    {"tolower", "nuconv_memcpy_lower", bench_nuconv_memcpy_lower},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    bench_run(cases[i].group, "ascii", 0, cases[i].impl, cases[i].fn, &m, m.n, m.n);
+  }
+  free(m.a);
+  free(m.b);
+}
+
+static void bench_usage(const char* argv0)
+{
+  fprintf(stderr,
+          "usage: %s [--json] [--count N] [--min-time SECONDS] [FILTER]\n"
+          "Prints one CSV (or JSON) record per benchmark; FILTER selects records\n"
+          "whose group/dataset/radix/impl name contains it.\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0) {
+      bench_json = true;
+    } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+      bench_count = (size_t)strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      bench_min_time = strtod(argv[++i], NULL);
+    } else if (argv[i][0] == '-') {
+      bench_usage(argv[0]);
+      return 2;
+    } else {
+      bench_filter = argv[i];
+    }
+  }
+  if (bench_count == 0) {
+    bench_usage(argv[0]);
+    return 2;
+  }
+
+  perf_open();
+  if (!bench_json) {
+    puts("group,dataset,radix,impl,ns_per_op,gb_per_s,cycles_per_op,branch_misses_per_op,checksum");
+  }
+
+  for (int kind = BENCH_UNIFORM; kind <= BENCH_INVALID; ++kind) {
+    bench_parse((enum bench_kind)kind, 10);
+    bench_parse((enum bench_kind)kind, 16);
+  }
+  for (int kind = BENCH_UNIFORM; kind <= BENCH_SKEWED; ++kind) {
+    bench_format((enum bench_kind)kind, 10);
+    bench_format((enum bench_kind)kind, 16);
+  }
+  bench_bulk(BENCH_UNIFORM, 10);
+  bench_bulk(BENCH_SKEWED, 10);
+  for (unsigned radix = 2; radix <= 36; ++radix) {
+    if (radix != 10 && radix != 16) {
+      bench_parse(BENCH_UNIFORM, radix);
+      bench_format(BENCH_UNIFORM, radix);
+    }
+  }
+
+  bench_float(BENCH_UNIFORM);
+  bench_float(BENCH_SKEWED);
+
+  for (size_t n = 16; n <= 65536; n *= 16) {
+    bench_memory(n);
+  }
+  bench_ctype();
+  return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef NUCONV_BENCH_H
+#define NUCONV_BENCH_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* count NUL-terminated strings packed into buf; string i starts at off[i]
+   and is len[i] characters long. */
+struct bench_strs {
+  char* buf;
+  size_t* off;
+  size_t* len;
+  size_t count;
+  size_t bytes;
+  unsigned radix;
+};
+
+struct bench_vals {
+  const void* vals;
+  size_t count;
+  size_t bytes;
+  unsigned radix;
+};
+
+#ifdef NUCONV_BENCH_CXX
+uint64_t bench_from_chars_i(const void* arg);
+uint64_t bench_from_chars_u(const void* arg);
+uint64_t bench_to_chars_i(const void* arg);
+uint64_t bench_to_chars_u(const void* arg);
+/* nuconv.hpp templates; radix 10 or 16 only. */
+uint64_t bench_hpp_parse_i(const void* arg);
+uint64_t bench_hpp_format_i(const void* arg);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NUCONV_BENCH_H */
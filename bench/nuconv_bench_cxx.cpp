@@ -0,0 +1,93 @@
+#include "nuconv_bench.h"
+
+#include <nuconv.hpp>
+
+#include <charconv>
+
+extern "C" uint64_t bench_from_chars_i(const void* arg)
+{
+  const bench_strs* s = static_cast<const bench_strs*>(arg);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    int64_t v = 0;
+    std::from_chars(p, p + s->len[i], v, static_cast<int>(s->radix));
+    sum += static_cast<uint64_t>(v);
+  }
+  return sum;
+}
+
+extern "C" uint64_t bench_from_chars_u(const void* arg)
+{
+  const bench_strs* s = static_cast<const bench_strs*>(arg);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    uint64_t v = 0;
+    std::from_chars(p, p + s->len[i], v, static_cast<int>(s->radix));
+    sum += v;
+  }
+  return sum;
+}
+
+template <unsigned Radix>
+static uint64_t bench_hpp_parse(const bench_strs* s)
+{
+  uint64_t sum = 0;
+  for (size_t i = 0; i < s->count; ++i) {
+    const char* p = s->buf + s->off[i];
+    int64_t v = 0;
+    nuconv::parse_n<int64_t, Radix>(v, p, p + s->len[i]);
+    sum += static_cast<uint64_t>(v);
+  }
+  return sum;
+}
+
+extern "C" uint64_t bench_hpp_parse_i(const void* arg)
+{
+  const bench_strs* s = static_cast<const bench_strs*>(arg);
+  return s->radix == 16 ? bench_hpp_parse<16>(s) : bench_hpp_parse<10>(s);
+}
+
+template <unsigned Radix>
+static uint64_t bench_hpp_format(const bench_vals* s)
+{
+  const int64_t* vals = static_cast<const int64_t*>(s->vals);
+  uint64_t sum = 0;
+  char out[nuconv::buffer_size<int64_t, Radix>];
+  for (size_t i = 0; i < s->count; ++i) {
+    sum += static_cast<uint64_t>(nuconv::format<int64_t, Radix>(vals[i], out))
+      + static_cast<unsigned char>(out[0]);
+  }
+  return sum;
+}
+
+extern "C" uint64_t bench_hpp_format_i(const void* arg)
+{
+  const bench_vals* s = static_cast<const bench_vals*>(arg);
+  return s->radix == 16 ? bench_hpp_format<16>(s) : bench_hpp_format<10>(s);
+}
+
+template <typename T>
+static uint64_t bench_to_chars(const bench_vals* s)
+{
+  const T* vals = static_cast<const T*>(s->vals);
+  uint64_t sum = 0;
+  char out[72];
+  for (size_t i = 0; i < s->count; ++i) {
+    std::to_chars_result r = std::to_chars(out, out + sizeof(out), vals[i],
+                                           static_cast<int>(s->radix));
+    sum += static_cast<uint64_t>(r.ptr - out) + static_cast<unsigned char>(out[0]);
+  }
+  return sum;
+}
+
+extern "C" uint64_t bench_to_chars_i(const void* arg)
+{
+  return bench_to_chars<int64_t>(static_cast<const bench_vals*>(arg));
+}
+
+extern "C" uint64_t bench_to_chars_u(const void* arg)
+{
+  return bench_to_chars<uint64_t>(static_cast<const bench_vals*>(arg));
+}
@@ -0,0 +1,789 @@
+#define _GNU_SOURCE
+
+#include <nuconv.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Text is parsed in windows of at least this many bytes, cut after a
+   delimiter, so the value and status arrays stay bounded for any input. */
+#define CLI_WINDOW   (4u << 20)
+/* Values formatted per nuconv_do_*toa_bulk call. */
+#define CLI_BLOCK    (8192)
+/* Widest formatted value: 64 binary digits and a sign. */
+#define CLI_MAX_TEXT (65)
+/* Input that cannot be mapped goes through a ring of this many blocks,
+   filled by a reader thread while the previous block is converted. */
+#define CLI_RING_SLOTS (4)
+#define CLI_RING_BLOCK (1u << 19)
+
+struct cli_opts {
+  bool format;
+  bool sig;
+  bool stats;
+  bool stream;
+  unsigned radix;
+  unsigned width;
+  unsigned threads;
+  int flags;
+  const char* delims;
+  const char* sep;
+  const char* input;
+  const char* output;
+};
+
+struct cli_input {
+  const char* data;
+  size_t size;
+  int fd;
+  bool mapped;
+};
+
+/* Heap-allocated: when conversion stops early the reader is detached while
+   possibly blocked in read(), and then frees the ring itself. */
+struct cli_ring {
+  pthread_t tid;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  char* buf;
+  size_t len[CLI_RING_SLOTS];
+  size_t head;
+  size_t tail;
+  size_t bytes;
+  int fd;
+  int err;
+  bool eof;
+  bool quit;
+};
+
+static const char* cli_name = "nuconv";
+static const char cli_digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static void cli_usage(FILE* f)
+{
+  fprintf(f,
+          "usage: %s parse  [options] [FILE]   text integers to a binary column\n"
+          "       %s format [options] [FILE]   binary column to text integers\n"
+          "\n"
+          "  -r, --radix N      radix 2-36 (default 10)\n"
+          "  -w, --width BITS   element width 8, 16, 32 or 64 (default 64)\n"
+          "  -u, --unsigned     unsigned elements\n"
+          "  -d, --delims STR   parse: field delimiters (default \" \\t\\r\\n,\")\n"
+          "  -s, --sep STR      format: value separator (default \"\\n\")\n"
+          "  -U, --upper        format: uppercase digits\n"
+          "  -j, --threads N    parse: worker threads, 0 for one per CPU (default 0)\n"
+          "  -o, --output FILE  write to FILE instead of standard output\n"
+          "  -v, --stats        report throughput on standard error\n"
+          "      --stream       read through the pipelined reader even for files\n"
+          "\n"
+          "Binary columns are packed in host byte order. Empty fields are skipped.\n"
+          "Regular files are mapped; other input is streamed in bounded memory.\n",
+          cli_name, cli_name);
+}
+
+static double cli_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool cli_parse_uint(const char* arg, unsigned* dst)
+{
+  uint32_t v;
+  const char* stop;
+  if (nuconv_do_atou32(&v, arg, NULL, &stop, 10, 0) != NUCONV_OK
+      || *stop != '\0') {
+    return false;
+  }
+  *dst = v;
+  return true;
+}
+
+static int cli_options(struct cli_opts* o, int argc, char** argv)
+{
+  o->format = false;
+  o->sig = true;
+  o->stats = false;
+  o->stream = false;
+  o->radix = 10;
+  o->width = 64;
+  o->threads = 0;
+  o->flags = 0;
+  o->delims = " \t\r\n,";
+  o->sep = "\n";
+  o->input = NULL;
+  o->output = NULL;
+
+  if (argc < 2) {
+    cli_usage(stderr);
+    return -1;
+  }
+  if (strcmp(argv[1], "format") == 0) {
+    o->format = true;
+  } else if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+    cli_usage(stdout);
+    return 1;
+  } else if (strcmp(argv[1], "parse") != 0) {
+    fprintf(stderr, "%s: unknown command '%s'\n", cli_name, argv[1]);
+    cli_usage(stderr);
+    return -1;
+  }
+
+  for (int i = 2; i < argc; ++i) {
+    const char* a = argv[i];
+    const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (strcmp(a, "-u") == 0 || strcmp(a, "--unsigned") == 0) {
+      o->sig = false;
+      continue;
+    } else if (strcmp(a, "-U") == 0 || strcmp(a, "--upper") == 0) {
+      o->flags |= NUCONV_FLAG_UPPERCASE;
+      continue;
+    } else if (strcmp(a, "-v") == 0 || strcmp(a, "--stats") == 0) {
+      o->stats = true;
+      continue;
+    } else if (strcmp(a, "--stream") == 0) {
+      o->stream = true;
+      continue;
+    } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+      cli_usage(stdout);
+      return 1;
+    } else if (a[0] != '-' || a[1] == '\0') {
+      if (o->input != NULL) {
+        fprintf(stderr, "%s: more than one input file\n", cli_name);
+        return -1;
+      }
+      o->input = a;
+      continue;
+    } else if (v == NULL) {
+      fprintf(stderr, "%s: option '%s' needs an argument\n", cli_name, a);
+      return -1;
+    } else if (strcmp(a, "-r") == 0 || strcmp(a, "--radix") == 0) {
+      ok = cli_parse_uint(v, &o->radix) && o->radix >= 2 && o->radix <= 36;
+    } else if (strcmp(a, "-w") == 0 || strcmp(a, "--width") == 0) {
+      ok = cli_parse_uint(v, &o->width)
+        && (o->width == 8 || o->width == 16 || o->width == 32 || o->width == 64);
+    } else if (strcmp(a, "-j") == 0 || strcmp(a, "--threads") == 0) {
+      ok = cli_parse_uint(v, &o->threads);
+    } else if (strcmp(a, "-d") == 0 || strcmp(a, "--delims") == 0) {
+      o->delims = v;
+    } else if (strcmp(a, "-s") == 0 || strcmp(a, "--sep") == 0) {
+      o->sep = v;
+    } else if (strcmp(a, "-o") == 0 || strcmp(a, "--output") == 0) {
+      o->output = v;
+    } else {
+      fprintf(stderr, "%s: unknown option '%s'\n", cli_name, a);
+      return -1;
+    }
+    if (!ok) {
+      fprintf(stderr, "%s: invalid value '%s' for %s\n", cli_name, v, a);
+      return -1;
+    }
+    ++i;
+  }
+  return 0;
+}
+
+/* Maps regular files unless streaming was requested; anything else is left
+   open for the pipelined reader. */
+static int cli_open_input(struct cli_input* in, const char* path, bool stream)
+{
+  in->fd = path == NULL || strcmp(path, "-") == 0
+    ? STDIN_FILENO
+    : open(path, O_RDONLY);
+  struct stat st;
+  in->data = NULL;
+  in->size = 0;
+  in->mapped = false;
+  if (in->fd < 0) {
+    fprintf(stderr, "%s: %s: %s\n", cli_name, path, strerror(errno));
+    return -1;
+  }
+  if (!stream && fstat(in->fd, &st) == 0 && S_ISREG(st.st_mode)
+      && st.st_size > 0) {
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, in->fd, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+      in->data = p;
+      in->size = (size_t)st.st_size;
+      in->mapped = true;
+    }
+  }
+  return 0;
+}
+
+static void cli_close_input(struct cli_input* in)
+{
+  if (in->mapped) {
+    munmap((void*)in->data, in->size);
+  }
+  if (in->fd != STDIN_FILENO) {
+    close(in->fd);
+  }
+}
+
+static void cli_ring_free(struct cli_ring* r)
+{
+  close(r->fd);
+  pthread_mutex_destroy(&r->lock);
+  pthread_cond_destroy(&r->cond);
+  free(r->buf);
+  free(r);
+}
+
+/* Fills free slots with whole blocks (short only at end of input) and
+   publishes them in order. Seeing quit before end of input means the
+   consumer has detached and left the ring to this thread. */
+static void* cli_reader(void* arg)
+{
+  struct cli_ring* r = arg;
+  for (;;) {
+    pthread_mutex_lock(&r->lock);
+    while (r->head - r->tail == CLI_RING_SLOTS && !r->quit) {
+      pthread_cond_wait(&r->cond, &r->lock);
+    }
+    const size_t slot = r->head % CLI_RING_SLOTS;
+    const bool quit = r->quit;
+    pthread_mutex_unlock(&r->lock);
+    if (quit) {
+      cli_ring_free(r);
+      return NULL;
+    }
+
+    char* p = r->buf + slot * CLI_RING_BLOCK;
+    size_t n = 0;
+    ssize_t k = 1;
+    while (n < CLI_RING_BLOCK) {
+      k = read(r->fd, p + n, CLI_RING_BLOCK - n);
+      if (k > 0) {
+        n += (size_t)k;
+      } else if (k == 0 || errno != EINTR) {
+        break;
+      }
+    }
+
+    pthread_mutex_lock(&r->lock);
+    if (r->quit) {
+      pthread_mutex_unlock(&r->lock);
+      cli_ring_free(r);
+      return NULL;
+    }
+    r->len[slot] = n;
+    r->head += n != 0;
+    r->bytes += n;
+    if (k <= 0) {
+      r->eof = true;
+      r->err = k < 0 ? errno : 0;
+    }
+    pthread_cond_broadcast(&r->cond);
+    pthread_mutex_unlock(&r->lock);
+    if (k <= 0) {
+      return NULL;
+    }
+  }
+}
+
+/* Waits for the next filled block; false once the input is exhausted. */
+static bool cli_ring_acquire(struct cli_ring* r, const char** data,
+                             size_t* len)
+{
+  pthread_mutex_lock(&r->lock);
+  while (r->tail == r->head && !r->eof) {
+    pthread_cond_wait(&r->cond, &r->lock);
+  }
+  const bool ok = r->tail != r->head;
+  if (ok) {
+    const size_t slot = r->tail % CLI_RING_SLOTS;
+    *data = r->buf + slot * CLI_RING_BLOCK;
+    *len = r->len[slot];
+  }
+  pthread_mutex_unlock(&r->lock);
+  return ok;
+}
+
+static void cli_ring_release(struct cli_ring* r)
+{
+  pthread_mutex_lock(&r->lock);
+  ++r->tail;
+  pthread_cond_broadcast(&r->cond);
+  pthread_mutex_unlock(&r->lock);
+}
+
+static struct cli_ring* cli_ring_start(int fd)
+{
+  struct cli_ring* r = malloc(sizeof(*r));
+  char* buf = malloc((size_t)CLI_RING_SLOTS * CLI_RING_BLOCK);
+  if (r == NULL || buf == NULL) {
+    fprintf(stderr, "%s: out of memory\n", cli_name);
+    free(r);
+    free(buf);
+    return NULL;
+  }
+  /* The reader keeps its own descriptor, which stays valid after the
+     input is closed under a detached reader. */
+  fd = dup(fd);
+  if (fd < 0) {
+    fprintf(stderr, "%s: dup: %s\n", cli_name, strerror(errno));
+    free(r);
+    free(buf);
+    return NULL;
+  }
+  r->buf = buf;
+  r->head = r->tail = r->bytes = 0;
+  r->fd = fd;
+  r->err = 0;
+  r->eof = r->quit = false;
+  pthread_mutex_init(&r->lock, NULL);
+  pthread_cond_init(&r->cond, NULL);
+  if (pthread_create(&r->tid, NULL, cli_reader, r) != 0) {
+    fprintf(stderr, "%s: cannot start reader thread\n", cli_name);
+    cli_ring_free(r);
+    return NULL;
+  }
+  return r;
+}
+
+/* Stops the reader and releases the ring; *bytes receives the input size
+   read. When conversion failed before end of input the reader may be
+   blocked in read(), so it is detached and frees the ring once it wakes. */
+static int cli_ring_stop(struct cli_ring* r, int ret, size_t* bytes)
+{
+  pthread_mutex_lock(&r->lock);
+  r->quit = true;
+  pthread_cond_broadcast(&r->cond);
+  const int err = r->err;
+  const bool eof = r->eof;
+  const pthread_t tid = r->tid;
+  *bytes = r->bytes;
+  pthread_mutex_unlock(&r->lock);
+  if (!eof) {
+    pthread_detach(tid);
+    return ret;
+  }
+  pthread_join(tid, NULL);
+  cli_ring_free(r);
+  if (ret == 0 && err != 0) {
+    fprintf(stderr, "%s: read: %s\n", cli_name, strerror(err));
+    return -1;
+  }
+  return ret;
+}
+
+static int cli_write(int fd, const void* buf, size_t n)
+{
+  const char* p = buf;
+  while (n != 0) {
+    const ssize_t w = write(fd, p, n);
+    if (w < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "%s: write: %s\n", cli_name, strerror(errno));
+      return -1;
+    }
+    p += w;
+    n -= (size_t)w;
+  }
+  return 0;
+}
+
+static const char* cli_status_text(int status)
+{
+  switch (status) {
+  case -NUCONV_ERROR_INVALID_CHARACTER:
+    return "invalid character";
+  case NUCONV_WARN_OVERFLOW:
+    return "value out of range";
+  default:
+    return "parse error";
+  }
+}
+
+/* Drops empty fields and narrows the rest to width bits in place, returning
+   the packed byte count or -1 after reporting the first bad value; base is
+   the number of values packed by earlier calls. */
+static ssize_t cli_pack(const struct cli_opts* o, uint64_t* vals, int* status,
+                        size_t count, size_t base)
+{
+  const unsigned bytes = o->width / 8;
+  const uint64_t umax = o->width == 64 ? UINT64_MAX : ((uint64_t)1 << o->width) - 1;
+  const int64_t smax = (int64_t)(umax >> 1);
+  char* out = (char*)vals;
+  size_t n = 0;
+  for (size_t i = 0; i < count; ++i) {
+    int r = status[i];
+    if (r == -NUCONV_ERROR_EMPTY) {
+      continue;
+    }
+    const uint64_t v = vals[i];
+    if (r == NUCONV_OK && o->width != 64) {
+      const bool fits = o->sig
+        ? (int64_t)v >= -smax - 1 && (int64_t)v <= smax
+        : v <= umax;
+      r = fits ? NUCONV_OK : NUCONV_WARN_OVERFLOW;
+    }
+    if (r != NUCONV_OK) {
+      fprintf(stderr, "%s: value %zu: %s\n", cli_name, base + n / bytes + 1,
+              cli_status_text(r));
+      return -1;
+    }
+    switch (bytes) {
+    case 1: {
+      const uint8_t x = (uint8_t)v;
+      memcpy(out + n, &x, 1);
+      break;
+    }
+    case 2: {
+      const uint16_t x = (uint16_t)v;
+      memcpy(out + n, &x, 2);
+      break;
+    }
+    case 4: {
+      const uint32_t x = (uint32_t)v;
+      memcpy(out + n, &x, 4);
+      break;
+    }
+    default:
+      memcpy(out + n, &v, 8);
+      break;
+    }
+    n += bytes;
+  }
+  return (ssize_t)n;
+}
+
+static int cli_parse(const struct cli_opts* o, const struct cli_input* in,
+                     int fd, size_t* values)
+{
+  const char* ptr = in->data;
+  const char* end = in->data + in->size;
+  const size_t window = CLI_WINDOW > (size_t)o->threads << 20
+    ? CLI_WINDOW
+    : (size_t)o->threads << 20;
+  uint64_t* vals = NULL;
+  int* status = NULL;
+  size_t cap = 0;
+  int ret = 0;
+
+  /* As in the library, delimiters that are digits of the radix are part of
+     the field. */
+  bool delim[256] = {false};
+  for (const char* d = o->delims; *d != '\0'; ++d) {
+    const char* digit = strchr(cli_digits, tolower((unsigned char)*d));
+    delim[(unsigned char)*d] = digit == NULL || digit - cli_digits >= (ptrdiff_t)o->radix;
+  }
+
+  while (ptr != end) {
+    /* Extend the window to just past a delimiter so no field straddles two
+       windows. */
+    const char* wend = (size_t)(end - ptr) > window ? ptr + window : end;
+    while (wend != end && !delim[(unsigned char)wend[-1]]) {
+      ++wend;
+    }
+    size_t count = (size_t)(wend - ptr) + 1;
+    if (count > cap) {
+      free(vals);
+      free(status);
+      cap = count;
+      vals = malloc(cap * sizeof(*vals));
+      status = malloc(cap * sizeof(*status));
+      if (vals == NULL || status == NULL) {
+        fprintf(stderr, "%s: out of memory\n", cli_name);
+        ret = -1;
+        break;
+      }
+    }
+    const char* stop;
+    if (o->sig) {
+      nuconv_do_atoi_bulk_parallel((int64_t*)vals, status, &count, ptr, wend,
+                                   &stop, o->delims, o->radix, 0, o->threads);
+    } else {
+      nuconv_do_atou_bulk_parallel(vals, status, &count, ptr, wend, &stop,
+                                   o->delims, o->radix, 0, o->threads);
+    }
+    const ssize_t n = cli_pack(o, vals, status, count, *values);
+    if (n < 0 || cli_write(fd, vals, (size_t)n) != 0) {
+      ret = -1;
+      break;
+    }
+    *values += (size_t)n / (o->width / 8);
+    ptr = wend;
+  }
+  free(vals);
+  free(status);
+  return ret;
+}
+
+static void cli_widen(const struct cli_opts* o, const char* src, size_t count,
+                      uint64_t* dst)
+{
+  for (size_t i = 0; i < count; ++i) {
+    const char* p = src + i * (o->width / 8);
+    switch (o->width) {
+    case 8: {
+      uint8_t x;
+      memcpy(&x, p, 1);
+      dst[i] = o->sig ? (uint64_t)(int64_t)(int8_t)x : x;
+      break;
+    }
+    case 16: {
+      uint16_t x;
+      memcpy(&x, p, 2);
+      dst[i] = o->sig ? (uint64_t)(int64_t)(int16_t)x : x;
+      break;
+    }
+    case 32: {
+      uint32_t x;
+      memcpy(&x, p, 4);
+      dst[i] = o->sig ? (uint64_t)(int64_t)(int32_t)x : x;
+      break;
+    }
+    default:
+      memcpy(&dst[i], p, 8);
+      break;
+    }
+  }
+}
+
+/* Formats count values into text and writes them, preceded by sep unless
+   they are the first of the output. */
+static int cli_emit(const struct cli_opts* o, const uint64_t* vals,
+                    size_t count, char* text, int fd, bool* first)
+{
+  const size_t seplen = *first ? 0 : strlen(o->sep);
+  size_t len;
+  memcpy(text, o->sep, seplen);
+  if (o->sig) {
+    nuconv_do_itoa_bulk((const int64_t*)vals, count, text + seplen, NULL, &len,
+                        o->sep, o->radix, o->flags);
+  } else {
+    nuconv_do_utoa_bulk(vals, count, text + seplen, NULL, &len, o->sep,
+                        o->radix, o->flags);
+  }
+  *first = false;
+  return cli_write(fd, text, seplen + len);
+}
+
+static char* cli_text_alloc(const struct cli_opts* o)
+{
+  char* text = malloc(CLI_BLOCK * (CLI_MAX_TEXT + strlen(o->sep)) + 1);
+  if (text == NULL) {
+    fprintf(stderr, "%s: out of memory\n", cli_name);
+  }
+  return text;
+}
+
+/* Values are joined by sep and the output ends with a newline. */
+static int cli_format_blocks(const struct cli_opts* o, const char* data,
+                             size_t count, uint64_t* vals, char* text, int fd,
+                             bool* first)
+{
+  const size_t bytes = o->width / 8;
+  for (size_t i = 0; i < count; i += CLI_BLOCK) {
+    const size_t n = count - i < CLI_BLOCK ? count - i : CLI_BLOCK;
+    cli_widen(o, data + i * bytes, n, vals);
+    if (cli_emit(o, vals, n, text, fd, first) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int cli_format(const struct cli_opts* o, const struct cli_input* in,
+                      int fd, size_t* values)
+{
+  const size_t bytes = o->width / 8;
+  if (in->size % bytes != 0) {
+    fprintf(stderr, "%s: input size %zu is not a multiple of %zu bytes\n",
+            cli_name, in->size, bytes);
+    return -1;
+  }
+  uint64_t* vals = malloc(CLI_BLOCK * sizeof(*vals));
+  char* text = cli_text_alloc(o);
+  bool first = true;
+  int ret = vals != NULL && text != NULL ? 0 : -1;
+  if (ret == 0) {
+    ret = cli_format_blocks(o, in->data, in->size / bytes, vals, text, fd,
+                            &first);
+  }
+  if (ret == 0 && !first) {
+    ret = cli_write(fd, "\n", 1);
+  }
+  *values = in->size / bytes;
+  free(vals);
+  free(text);
+  return ret;
+}
+
+/* Streaming parse: the resumable parser carries a field split between two
+   blocks over to the next one. */
+static int cli_stream_parse(const struct cli_opts* o, struct cli_input* in,
+                            int fd, size_t* values)
+{
+  struct cli_ring* ring = NULL;
+  struct nuconv_stream st;
+  const size_t cap = CLI_RING_BLOCK + 1;
+  uint64_t* vals = malloc(cap * sizeof(*vals));
+  int* status = malloc(cap * sizeof(*status));
+  if (vals == NULL || status == NULL) {
+    fprintf(stderr, "%s: out of memory\n", cli_name);
+    free(vals);
+    free(status);
+    return -1;
+  }
+  nuconv_stream_init(&st, o->delims, o->radix, 0);
+  ring = cli_ring_start(in->fd);
+  int ret = ring != NULL ? 0 : -1;
+  const char* data;
+  size_t len;
+  while (ret == 0 && cli_ring_acquire(ring, &data, &len)) {
+    size_t count = cap;
+    if (o->sig) {
+      nuconv_stream_feedi(&st, (int64_t*)vals, status, &count, data,
+                          data + len, NULL);
+    } else {
+      nuconv_stream_feedu(&st, vals, status, &count, data, data + len, NULL);
+    }
+    cli_ring_release(ring);
+    const ssize_t n = cli_pack(o, vals, status, count, *values);
+    if (n < 0 || cli_write(fd, vals, (size_t)n) != 0) {
+      ret = -1;
+      break;
+    }
+    *values += (size_t)n / (o->width / 8);
+  }
+  if (ret == 0) {
+    size_t count;
+    status[0] = o->sig
+      ? nuconv_stream_finishi(&st, (int64_t*)vals, &count)
+      : nuconv_stream_finishu(&st, vals, &count);
+    const ssize_t n = cli_pack(o, vals, status, count, *values);
+    if (n < 0 || cli_write(fd, vals, (size_t)n) != 0) {
+      ret = -1;
+    } else {
+      *values += (size_t)n / (o->width / 8);
+    }
+  }
+  if (ring != NULL) {
+    ret = cli_ring_stop(ring, ret, &in->size);
+  }
+  free(vals);
+  free(status);
+  return ret;
+}
+
+/* Streaming format: an element split between two blocks is completed in
+   a small carry buffer. */
+static int cli_stream_format(const struct cli_opts* o, struct cli_input* in,
+                             int fd, size_t* values)
+{
+  struct cli_ring* ring = NULL;
+  const size_t bytes = o->width / 8;
+  char carry[8];
+  size_t carried = 0;
+  bool first = true;
+  uint64_t* vals = malloc(CLI_BLOCK * sizeof(*vals));
+  char* text = cli_text_alloc(o);
+  int ret = vals != NULL && text != NULL ? 0 : -1;
+  if (ret == 0) {
+    ring = cli_ring_start(in->fd);
+    ret = ring != NULL ? 0 : -1;
+  }
+  const char* data;
+  size_t len;
+  while (ret == 0 && cli_ring_acquire(ring, &data, &len)) {
+    if (carried != 0) {
+      const size_t take = bytes - carried < len ? bytes - carried : len;
+      memcpy(carry + carried, data, take);
+      carried += take;
+      data += take;
+      len -= take;
+      if (carried == bytes) {
+        ret = cli_format_blocks(o, carry, 1, vals, text, fd, &first);
+        carried = 0;
+        ++*values;
+      }
+    }
+    const size_t count = len / bytes;
+    if (ret == 0) {
+      ret = cli_format_blocks(o, data, count, vals, text, fd, &first);
+    }
+    *values += count;
+    memcpy(carry + carried, data + count * bytes, len - count * bytes);
+    carried += len - count * bytes;
+    cli_ring_release(ring);
+  }
+  if (ret == 0 && carried != 0) {
+    fprintf(stderr, "%s: input size is not a multiple of %zu bytes\n",
+            cli_name, bytes);
+    ret = -1;
+  }
+  if (ret == 0 && !first) {
+    ret = cli_write(fd, "\n", 1);
+  }
+  if (ring != NULL) {
+    ret = cli_ring_stop(ring, ret, &in->size);
+  }
+  free(vals);
+  free(text);
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  struct cli_opts o;
+  struct cli_input in;
+  const int r = cli_options(&o, argc, argv);
+  if (r != 0) {
+    return r > 0 ? 0 : 2;
+  }
+  if (cli_open_input(&in, o.input, o.stream) != 0) {
+    return 1;
+  }
+  int fd = STDOUT_FILENO;
+  if (o.output != NULL) {
+    fd = open(o.output, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+      fprintf(stderr, "%s: %s: %s\n", cli_name, o.output, strerror(errno));
+      cli_close_input(&in);
+      return 1;
+    }
+  }
+
+  size_t values = 0;
+  const double t0 = cli_now();
+  int ret;
+  if (in.mapped) {
+    ret = o.format
+      ? cli_format(&o, &in, fd, &values)
+      : cli_parse(&o, &in, fd, &values);
+  } else {
+    ret = o.format
+      ? cli_stream_format(&o, &in, fd, &values)
+      : cli_stream_parse(&o, &in, fd, &values);
+  }
+  const double t = cli_now() - t0;
+  if (fd != STDOUT_FILENO && close(fd) != 0) {
+    fprintf(stderr, "%s: %s: %s\n", cli_name, o.output, strerror(errno));
+    ret = -1;
+  }
+  if (ret == 0 && o.stats) {
+    fprintf(stderr, "%s: %zu values, %zu bytes in %.3f s (%.1f MB/s, %.1f Mvalues/s)\n",
+            o.format ? "format" : "parse", values, in.size, t,
+            t > 0 ? (double)in.size / t / 1e6 : 0.0,
+            t > 0 ? (double)values / t / 1e6 : 0.0);
+  }
+  cli_close_input(&in);
+  return ret == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+# Writes OUTPUT: include/nuconv.h followed, under NUCONV_IMPLEMENTATION, by
+# src/nuconv_internal.h and every src/*.c with their includes of the two
+# headers removed. Run with cmake -DSOURCE_DIR=... -DOUTPUT=... -P.
+
+file(GLOB SOURCES "${SOURCE_DIR}/src/*.c")
+list(SORT SOURCES)
+
+function(nuconv_append_file path)
+  file(READ "${path}" text)
+  string(REGEX REPLACE "#include <nuconv\\.h>\n" "" text "${text}")
+  string(REGEX REPLACE "#include \"nuconv_internal\\.h\"\n" "" text "${text}")
+  file(RELATIVE_PATH name "${SOURCE_DIR}" "${path}")
+  file(APPEND "${OUTPUT}" "\n/* ---- ${name} ---- */\n\n${text}")
+endfunction()
+
+file(READ "${SOURCE_DIR}/include/nuconv.h" header)
+file(WRITE "${OUTPUT}"
+"/* Single-header nuconv, generated from include/nuconv.h and src/. Include
+   it anywhere as nuconv.h; define NUCONV_IMPLEMENTATION before including it
+   in exactly one translation unit to compile the library there. */
+
+${header}
+#if defined(NUCONV_IMPLEMENTATION) && !defined(NUCONV_IMPLEMENTATION_INCLUDED)
+#define NUCONV_IMPLEMENTATION_INCLUDED 1
+")
+nuconv_append_file("${SOURCE_DIR}/src/nuconv_internal.h")
+foreach(source ${SOURCES})
+  nuconv_append_file("${source}")
+endforeach()
+file(APPEND "${OUTPUT}" "\n#endif /* NUCONV_IMPLEMENTATION */\n")
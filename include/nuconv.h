@@ -31,6 +31,11 @@ extern "C" {
 #define NUCONV_FLAG_UPPERCASE (0x00000001)
 #define NUCONV_FLAG_ABS       (0x00000002)
 
+#define NUCONV_TIER_BEST   (-1)
+#define NUCONV_TIER_SCALAR (0)
+#define NUCONV_TIER_SSE41  (1)
+#define NUCONV_TIER_AVX2   (2)
+
 void* nuconv_memchr(const void* x, int y, size_t z);
 int nuconv_memcmp(const char* x, const char* y, size_t z);
 void* nuconv_memcpy(void* dst, const void* src, size_t z);
@@ -49,7 +54,24 @@ char* nuconv_strset(char* x, int y);
 char* nuconv_strstr(const char* haystack,
                     const char* needle);
 
-extern uint16_t nuconv_ctype[];
+/* Locale-free ASCII class table (NUCONV_* class bits), 64-byte aligned.
+   Bytes >= 0x80 belong to no class. */
+extern const uint16_t nuconv_ctype[256];
+
+static inline int nuconv_ctype_is(int c, int mask)
+{
+  return (nuconv_ctype[(unsigned char)c] & mask) != 0;
+}
+
+static inline int nuconv_ctype_tolower(int c)
+{
+  return c + (nuconv_ctype_is(c, NUCONV_UPPER) << 5);
+}
+
+static inline int nuconv_ctype_toupper(int c)
+{
+  return c - (nuconv_ctype_is(c, NUCONV_LOWER) << 5);
+}
 
 int nuconv_isalnum(int c);
 int nuconv_isalpha(int c);
@@ -64,21 +86,213 @@ int nuconv_isblank(int c);
 int nuconv_isprint(int c);
 int nuconv_ispunct(int c);
 
+/* Length of the leading run of buf[0, n) whose bytes are (memspn) or are
+   not (memcspn) in any of the NUCONV_* classes in mask. */
+size_t nuconv_memspn(const char* buf, size_t n, int mask);
+size_t nuconv_memcspn(const char* buf, size_t n, int mask);
+/* Sets bit i % 64 of bits[i / 64] when buf[i] is in any class of mask; bits
+   must hold (n + 63) / 64 words. */
+void nuconv_memclass(const char* buf, size_t n, int mask, uint64_t* bits);
+
 int nuconv_tolower(int c);
 int nuconv_toupper(int c);
 
+/* The out-of-line functions above remain exported; these expand calls to
+   the inline table lookups. */
+#define nuconv_isalnum(c)  nuconv_ctype_is((c), NUCONV_ALNUM)
+#define nuconv_isalpha(c)  nuconv_ctype_is((c), NUCONV_ALPHA)
+#define nuconv_islower(c)  nuconv_ctype_is((c), NUCONV_LOWER)
+#define nuconv_isupper(c)  nuconv_ctype_is((c), NUCONV_UPPER)
+#define nuconv_isdigit(c)  nuconv_ctype_is((c), NUCONV_DIGIT)
+#define nuconv_isxdigit(c) nuconv_ctype_is((c), NUCONV_XDIGIT)
+#define nuconv_iscntrl(c)  nuconv_ctype_is((c), NUCONV_CNTRL)
+#define nuconv_isgraph(c)  nuconv_ctype_is((c), NUCONV_GRAPH)
+#define nuconv_isspace(c)  nuconv_ctype_is((c), NUCONV_SPACE)
+#define nuconv_isblank(c)  nuconv_ctype_is((c), NUCONV_BLANK)
+#define nuconv_isprint(c)  nuconv_ctype_is((c), NUCONV_PRINT)
+#define nuconv_ispunct(c)  nuconv_ctype_is((c), NUCONV_PUNCT)
+#define nuconv_tolower(c)  nuconv_ctype_tolower(c)
+#define nuconv_toupper(c)  nuconv_ctype_toupper(c)
+
+/* ASCII case conversion of whole buffers; the copying variants fold case
+   while copying and allow dst == src but no other overlap. */
+char* nuconv_memlower(char* buf, size_t n);
+char* nuconv_memupper(char* buf, size_t n);
+void* nuconv_memcpy_lower(void* dst, const void* src, size_t n);
+void* nuconv_memcpy_upper(void* dst, const void* src, size_t n);
+
+/* A value outside the 64-bit type returns NUCONV_WARN_OVERFLOW and stores
+   the low 64 bits of its exact (signed) value, so "9223372036854775808"
+   gives INT64_MIN; the same holds for nuconv_do_atoin/nuconv_do_atoun and
+   the bulk and stream parsers. The width-specific forms below saturate. */
 int nuconv_do_atoi(int64_t* dst, const char* target, unsigned radix, int flags);
 int nuconv_do_atou(uint64_t* dst, const char* target, unsigned radix, int flags);
 
+/* Parse [begin, end) without reading past end; a NULL end parses up to the
+   terminating NUL. When stop is not NULL it receives the first unconsumed
+   character. */
+int nuconv_do_atoin(int64_t* dst, const char* begin, const char* end,
+                    const char** stop, unsigned radix, int flags);
+int nuconv_do_atoun(uint64_t* dst, const char* begin, const char* end,
+                    const char** stop, unsigned radix, int flags);
+
+/* Width-specific forms of nuconv_do_atoin/nuconv_do_atoun. A value outside
+   the target type returns NUCONV_WARN_OVERFLOW and stores the value
+   saturated to the type's range. */
+int nuconv_do_atoi8 (int8_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atoi16(int16_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atoi32(int32_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atoi64(int64_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atou8 (uint8_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atou16(uint16_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atou32(uint32_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+int nuconv_do_atou64(uint64_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags);
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 nuconv_int128;
+__extension__ typedef unsigned __int128 nuconv_uint128;
+
+int nuconv_do_atoi128(nuconv_int128* dst, const char* begin, const char* end,
+                      const char** stop, unsigned radix, int flags);
+int nuconv_do_atou128(nuconv_uint128* dst, const char* begin, const char* end,
+                      const char** stop, unsigned radix, int flags);
+#endif
+
+/* Parse a decimal floating-point number ([+-]digits[.digits][e[+-]digits],
+   inf, infinity or nan, case-insensitively), correctly rounded to nearest.
+   Returns NUCONV_WARN_OVERFLOW when the result rounds to infinity. */
+int nuconv_do_atod(double* dst, const char* begin, const char* end,
+                   const char** stop, int flags);
+
+/* Parse up to *count fields of [begin, end) (NUL-terminated when end is
+   NULL) separated by any character of delims into dst, storing each field's
+   nuconv_do_atoin result in status (which may be NULL). *count receives the
+   number of fields parsed and stop the position after the last consumed
+   delimiter. Returns NUCONV_OK when every field parsed cleanly, otherwise the
+   first non-OK field status. */
+int nuconv_do_atoi_bulk(int64_t* dst, int* status, size_t* count,
+                        const char* begin, const char* end, const char** stop,
+                        const char* delims, unsigned radix, int flags);
+int nuconv_do_atou_bulk(uint64_t* dst, int* status, size_t* count,
+                        const char* begin, const char* end, const char** stop,
+                        const char* delims, unsigned radix, int flags);
+
+/* nuconv_do_atoi_bulk/nuconv_do_atou_bulk split across threads (0 for one per
+   online CPU): the input is cut at delimiters into chunks that a pool of
+   threads claims in turn, and results land in dst in input order. Small
+   inputs, and builds without the standard library, parse sequentially. */
+int nuconv_do_atoi_bulk_parallel(int64_t* dst, int* status, size_t* count,
+                                 const char* begin, const char* end,
+                                 const char** stop, const char* delims,
+                                 unsigned radix, int flags, unsigned threads);
+int nuconv_do_atou_bulk_parallel(uint64_t* dst, int* status, size_t* count,
+                                 const char* begin, const char* end,
+                                 const char** stop, const char* delims,
+                                 unsigned radix, int flags, unsigned threads);
+
+/* Incremental form of the bulk parsers for input that arrives in chunks: a
+   field may be split anywhere between two nuconv_stream_feed* calls and
+   parses as if it had been contiguous. The members are private. */
+struct nuconv_stream {
+  uint64_t acc;
+  unsigned radix;
+  unsigned char sign;
+  unsigned char succ;
+  unsigned char overflow;
+  unsigned char skipping;
+  unsigned char pending;
+  unsigned char dv[256];
+};
+
+int nuconv_stream_init(struct nuconv_stream* s, const char* delims,
+                       unsigned radix, int flags);
+/* Parse the fields of [begin, end) completed by a delimiter, with the same
+   count, status, stop, NULL end and return conventions as
+   nuconv_do_atoi_bulk. An unterminated trailing field is kept in s for the
+   next call. */
+int nuconv_stream_feedi(struct nuconv_stream* s, int64_t* dst, int* status,
+                        size_t* count, const char* begin, const char* end,
+                        const char** stop);
+int nuconv_stream_feedu(struct nuconv_stream* s, uint64_t* dst, int* status,
+                        size_t* count, const char* begin, const char* end,
+                        const char** stop);
+/* Complete the pending field at end of input into *dst and reset s for
+   reuse. *count receives 1 when a field was pending (even one of skip
+   characters only, which yields -NUCONV_ERROR_EMPTY as in the bulk parsers)
+   and 0 otherwise, in which case *dst is untouched and NUCONV_OK returned. */
+int nuconv_stream_finishi(struct nuconv_stream* s, int64_t* dst,
+                          size_t* count);
+int nuconv_stream_finishu(struct nuconv_stream* s, uint64_t* dst,
+                          size_t* count);
+
+/* Return the number of characters written, excluding the terminating NUL. */
 int nuconv_do_itoa(int64_t target, char* buf, unsigned radix, int flags);
 int nuconv_do_utoa(uint64_t target, char* buf, unsigned radix, int flags);
 
+int nuconv_do_itoa8 (int8_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_itoa16(int16_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_itoa32(int32_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_itoa64(int64_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_utoa8 (uint8_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_utoa16(uint16_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_utoa32(uint32_t target, char* buf, unsigned radix, int flags);
+int nuconv_do_utoa64(uint64_t target, char* buf, unsigned radix, int flags);
+
+#ifdef __SIZEOF_INT128__
+/* buf must hold 130 bytes for radix 2. */
+int nuconv_do_itoa128(nuconv_int128 target, char* buf, unsigned radix,
+                      int flags);
+int nuconv_do_utoa128(nuconv_uint128 target, char* buf, unsigned radix,
+                      int flags);
+#endif
+
+/* Write the shortest decimal that parses back to target, in fixed notation
+   for exponents in [-6, 21) and as d.ddde+X otherwise. buf must hold
+   NUCONV_DTOA_BUFSIZE bytes. */
+#define NUCONV_DTOA_BUFSIZE (32)
+int nuconv_do_dtoa(double target, char* buf, int flags);
+
+/* Number of characters nuconv_do_itoa/nuconv_do_utoa would write, excluding
+   the terminating NUL, or 0 for an invalid radix. */
+size_t nuconv_itoa_len(int64_t target, unsigned radix, int flags);
+size_t nuconv_utoa_len(uint64_t target, unsigned radix);
+
+/* Format count values joined by sep into buf, which must hold
+   nuconv_*toa_bulk_len() + 1 bytes. offsets (may be NULL) receives the start
+   of each value and len (may be NULL) the total length excluding the
+   terminating NUL. */
+size_t nuconv_itoa_bulk_len(const int64_t* src, size_t count, const char* sep,
+                            unsigned radix, int flags);
+size_t nuconv_utoa_bulk_len(const uint64_t* src, size_t count, const char* sep,
+                            unsigned radix, int flags);
+int nuconv_do_itoa_bulk(const int64_t* src, size_t count, char* buf,
+                        size_t* offsets, size_t* len, const char* sep,
+                        unsigned radix, int flags);
+int nuconv_do_utoa_bulk(const uint64_t* src, size_t count, char* buf,
+                        size_t* offsets, size_t* len, const char* sep,
+                        unsigned radix, int flags);
+
 int nuconv_atoi(const char* buf);
-unsigned int nconv_atou(const char* buf);
+unsigned int nuconv_atou(const char* buf);
 
 char* nuconv_itoa(int n, char* buf, int radix);
 char* nuconv_utoa(unsigned int n, char* buf, int radix);
 
+/* Select the kernel tier, clamped to what the CPU supports; NUCONV_TIER_BEST
+   picks the highest one. The NUCONV_TIER environment variable ("scalar",
+   "sse4.1", "avx2", or the tier number) sets the initial tier; any other
+   value selects NUCONV_TIER_BEST. Not thread-safe against concurrent
+   conversions. Returns the tier in effect. */
+int nuconv_set_tier(int tier);
+int nuconv_get_tier(void);
 
 size_t             nuconv_zmin   (size_t x, size_t y);
 char               nuconv_cmin   (char x, char y);
@@ -114,6 +328,70 @@ long long          nuconv_llmax  (long long x, long long y);
 signed long long   nuconv_sllmax (signed long long x, signed long long y);
 unsigned long long nuconv_ullmax (unsigned long long x, unsigned long long y);
 
+/* The out-of-line min/max functions above remain exported; these expand
+   calls to inline definitions so they cost no call, even across a shared
+   library boundary. */
+#define NUCONV_MINMAX_INLINE(type, sfx)                                       \
+  static inline type nuconv_##sfx##min_inline(type x, type y)                 \
+  {                                                                           \
+    return x < y ? x : y;                                                     \
+  }                                                                           \
+  static inline type nuconv_##sfx##max_inline(type x, type y)                 \
+  {                                                                           \
+    return x > y ? x : y;                                                     \
+  }
+
+NUCONV_MINMAX_INLINE(size_t,             z)
+NUCONV_MINMAX_INLINE(char,               c)
+NUCONV_MINMAX_INLINE(signed char,        sc)
+NUCONV_MINMAX_INLINE(unsigned char,      uc)
+NUCONV_MINMAX_INLINE(short,              s)
+NUCONV_MINMAX_INLINE(signed short,       ss)
+NUCONV_MINMAX_INLINE(unsigned short,     us)
+NUCONV_MINMAX_INLINE(int,                i)
+NUCONV_MINMAX_INLINE(signed int,         si)
+NUCONV_MINMAX_INLINE(unsigned int,       ui)
+NUCONV_MINMAX_INLINE(long,               l)
+NUCONV_MINMAX_INLINE(signed long,        sl)
+NUCONV_MINMAX_INLINE(unsigned long,      ul)
+NUCONV_MINMAX_INLINE(long long,          ll)
+NUCONV_MINMAX_INLINE(signed long long,   sll)
+NUCONV_MINMAX_INLINE(unsigned long long, ull)
+
+#define nuconv_zmin(x, y)   nuconv_zmin_inline((x), (y))
+#define nuconv_cmin(x, y)   nuconv_cmin_inline((x), (y))
+#define nuconv_scmin(x, y)  nuconv_scmin_inline((x), (y))
+#define nuconv_ucmin(x, y)  nuconv_ucmin_inline((x), (y))
+#define nuconv_smin(x, y)   nuconv_smin_inline((x), (y))
+#define nuconv_ssmin(x, y)  nuconv_ssmin_inline((x), (y))
+#define nuconv_usmin(x, y)  nuconv_usmin_inline((x), (y))
+#define nuconv_imin(x, y)   nuconv_imin_inline((x), (y))
+#define nuconv_simin(x, y)  nuconv_simin_inline((x), (y))
+#define nuconv_uimin(x, y)  nuconv_uimin_inline((x), (y))
+#define nuconv_lmin(x, y)   nuconv_lmin_inline((x), (y))
+#define nuconv_slmin(x, y)  nuconv_slmin_inline((x), (y))
+#define nuconv_ulmin(x, y)  nuconv_ulmin_inline((x), (y))
+#define nuconv_llmin(x, y)  nuconv_llmin_inline((x), (y))
+#define nuconv_sllmin(x, y) nuconv_sllmin_inline((x), (y))
+#define nuconv_ullmin(x, y) nuconv_ullmin_inline((x), (y))
+
+#define nuconv_zmax(x, y)   nuconv_zmax_inline((x), (y))
+#define nuconv_cmax(x, y)   nuconv_cmax_inline((x), (y))
+#define nuconv_scmax(x, y)  nuconv_scmax_inline((x), (y))
+#define nuconv_ucmax(x, y)  nuconv_ucmax_inline((x), (y))
+#define nuconv_smax(x, y)   nuconv_smax_inline((x), (y))
+#define nuconv_ssmax(x, y)  nuconv_ssmax_inline((x), (y))
+#define nuconv_usmax(x, y)  nuconv_usmax_inline((x), (y))
+#define nuconv_imax(x, y)   nuconv_imax_inline((x), (y))
+#define nuconv_simax(x, y)  nuconv_simax_inline((x), (y))
+#define nuconv_uimax(x, y)  nuconv_uimax_inline((x), (y))
+#define nuconv_lmax(x, y)   nuconv_lmax_inline((x), (y))
+#define nuconv_slmax(x, y)  nuconv_slmax_inline((x), (y))
+#define nuconv_ulmax(x, y)  nuconv_ulmax_inline((x), (y))
+#define nuconv_llmax(x, y)  nuconv_llmax_inline((x), (y))
+#define nuconv_sllmax(x, y) nuconv_sllmax_inline((x), (y))
+#define nuconv_ullmax(x, y) nuconv_ullmax_inline((x), (y))
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,196 @@
+#ifndef NUCONV_HPP
+#define NUCONV_HPP 1
+
+#if (defined(_MSVC_LANG) ? _MSVC_LANG : __cplusplus) < 201703L
+#error "nuconv.hpp requires C++17"
+#endif
+
+#include <nuconv.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+/* Header-only counterparts of the nuconv_do_atoi and nuconv_do_itoa
+   families with the target type and radix fixed at compile time: no radix
+   validation at run time, divisions by a constant radix, and usable in
+   constant expressions. Results and statuses match the C functions of the
+   same width. */
+namespace nuconv {
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool is_integer_v = std::is_integral_v<T>
+  && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(std::uint64_t);
+
+/* Digit value of c, or 36 for characters that are not digits. */
+constexpr unsigned digit_value(char c) noexcept
+{
+  const unsigned u = static_cast<unsigned char>(c);
+  if (u - '0' < 10) {
+    return u - '0';
+  }
+  if ((u | 0x20) - 'a' < 26) {
+    return (u | 0x20) - 'a' + 10;
+  }
+  return 36;
+}
+
+/* Characters skipped anywhere in a number, as in the C parsers. */
+constexpr bool is_skip(char c) noexcept
+{
+  return c == ' ' || (c >= '\t' && c <= '\r') || c == '+' || c == '_';
+}
+
+/* Compares against growing powers of Radix instead of dividing. */
+template <unsigned Radix, typename U>
+constexpr int count_digits(U mag) noexcept
+{
+  int n = 1;
+  for (std::uint64_t p = Radix; mag >= p; p *= Radix) {
+    ++n;
+    if (p > std::numeric_limits<std::uint64_t>::max() / Radix) {
+      break;
+    }
+  }
+  return n;
+}
+
+/* Writes the digits of mag so that the last one lands at end[-1]. */
+template <unsigned Radix, typename U>
+constexpr void write_digits(char* end, U mag, bool upper) noexcept
+{
+  const char* alphabet = upper
+    ? "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    : "0123456789abcdefghijklmnopqrstuvwxyz";
+  if constexpr (Radix == 10) {
+    constexpr char pairs[] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+    while (mag >= 100) {
+      const unsigned r = static_cast<unsigned>(mag % 100);
+      mag /= 100;
+      *--end = pairs[2 * r + 1];
+      *--end = pairs[2 * r];
+    }
+    if (mag >= 10) {
+      *--end = pairs[2 * mag + 1];
+      *--end = pairs[2 * mag];
+      return;
+    }
+  }
+  do {
+    *--end = alphabet[mag % Radix];
+    mag /= Radix;
+  } while (mag != 0);
+}
+
+} // namespace detail
+
+/* Bytes format<T, Radix> may write, including the terminating NUL. */
+template <typename T, unsigned Radix = 10>
+inline constexpr std::size_t buffer_size =
+  static_cast<std::size_t>(detail::count_digits<Radix>(
+    std::is_signed_v<T>
+      ? std::make_unsigned_t<T>(std::numeric_limits<T>::max()) + 1u
+      : std::numeric_limits<std::make_unsigned_t<T>>::max()))
+  + std::is_signed_v<T> + 1;
+
+/* Parse [begin, end) into dst like nuconv_do_atoin (end may be nullptr for
+   NUL-terminated input); out-of-range values saturate and return
+   NUCONV_WARN_OVERFLOW, as nuconv_do_atoi8..64 and nuconv_do_atou8..64 do.
+   Named apart from parse so that parse(dst, str, nullptr) is unambiguous. */
+template <typename T, unsigned Radix = 10>
+constexpr int parse_n(T& dst, const char* begin, const char* end,
+                      const char** stop = nullptr) noexcept
+{
+  static_assert(detail::is_integer_v<T>, "T must be an integer of at most 64 bits");
+  static_assert(Radix >= 2 && Radix <= 36, "Radix must be in [2, 36]");
+  constexpr bool sig = std::is_signed_v<T>;
+  constexpr std::uint64_t max = std::numeric_limits<T>::max();
+  /* Largest magnitude of either sign; the sign may follow the digits. */
+  constexpr std::uint64_t limit = sig ? max + 1 : max;
+  std::uint64_t res = 0;
+  bool sign = false;
+  bool succ = false;
+  bool overflow = false;
+  const char* ptr = begin;
+  for (; ptr != end; ++ptr) {
+    const unsigned v = detail::digit_value(*ptr);
+    if (v < Radix) {
+      succ = true;
+      if (res > (limit - v) / Radix) {
+        overflow = true;
+      } else {
+        res = res * Radix + v;
+      }
+    } else if (sig && *ptr == '-') {
+      sign = true;
+    } else if (!detail::is_skip(*ptr)) {
+      break;
+    }
+  }
+  const bool looped = ptr != end && (end != nullptr || *ptr != '\0');
+  if (stop != nullptr) {
+    *stop = ptr;
+  }
+  overflow = overflow || res > max + sign;
+  if (overflow) {
+    res = max + sign;
+  }
+  dst = static_cast<T>(sign ? 0 - res : res);
+  return !succ
+    ? looped
+      ? -NUCONV_ERROR_INVALID_CHARACTER
+      : -NUCONV_ERROR_EMPTY
+    : overflow
+      ? NUCONV_WARN_OVERFLOW
+      : NUCONV_OK;
+}
+
+template <typename T, unsigned Radix = 10>
+constexpr int parse(T& dst, const char* str, const char** stop = nullptr) noexcept
+{
+  return parse_n<T, Radix>(dst, str, nullptr, stop);
+}
+
+template <typename T, unsigned Radix = 10>
+constexpr int parse(T& dst, std::string_view str,
+                    const char** stop = nullptr) noexcept
+{
+  return parse_n<T, Radix>(dst, str.data(), str.data() + str.size(), stop);
+}
+
+/* Format value into buf, which must hold buffer_size<T, Radix> bytes, like
+   nuconv_do_itoa; returns the length excluding the terminating NUL. */
+template <typename T, unsigned Radix = 10>
+constexpr int format(T value, char* buf, int flags = 0) noexcept
+{
+  static_assert(detail::is_integer_v<T>, "T must be an integer of at most 64 bits");
+  static_assert(Radix >= 2 && Radix <= 36, "Radix must be in [2, 36]");
+  using U = std::make_unsigned_t<T>;
+  bool neg = false;
+  if constexpr (std::is_signed_v<T>) {
+    neg = value < 0;
+  }
+  const U mag = neg ? static_cast<U>(U(0) - static_cast<U>(value))
+                    : static_cast<U>(value);
+  char* ptr = buf;
+  if (neg && (flags & NUCONV_FLAG_ABS) == 0) {
+    *ptr++ = '-';
+  }
+  ptr += detail::count_digits<Radix>(mag);
+  detail::write_digits<Radix>(ptr, mag, (flags & NUCONV_FLAG_UPPERCASE) != 0);
+  *ptr = '\0';
+  return static_cast<int>(ptr - buf);
+}
+
+} // namespace nuconv
+
+#endif /* NUCONV_HPP */
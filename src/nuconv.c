@@ -1,19 +1,37 @@
 #include <nuconv.h>
 #include <stdbool.h>
 
+#include "nuconv_internal.h"
+
 #ifndef NUCONV_NO_STDLIB
-#include <ctype.h>
 #include <string.h>
 #endif
 
+#ifdef NUCONV_NO_STDLIB
+typedef size_t __attribute__((may_alias)) nuconv_word;
+
+#define NUCONV_WSIZE (sizeof(nuconv_word))
+#define NUCONV_ONES  ((nuconv_word)-1 / 0xFF)
+#define NUCONV_HIGHS (NUCONV_ONES * 0x80)
+#define NUCONV_HASZERO(w) (((w) - NUCONV_ONES) & ~(w) & NUCONV_HIGHS)
+#define NUCONV_ALIGNED(p) (((uintptr_t)(p) & (NUCONV_WSIZE - 1)) == 0)
+
+static inline nuconv_word nuconv_loadw(const void* p)
+{
+  nuconv_word w;
+  __builtin_memcpy(&w, p, sizeof(w));
+  return w;
+}
+#endif
+
 #define NUCONV_MIN(type, fn) \
-type fn(type x, type y)      \
+type (fn)(type x, type y)    \
 {                            \
   return x < y ? x : y;      \
 }
 
 #define NUCONV_MAX(type, fn) \
-type fn(type x, type y)      \
+type (fn)(type x, type y)    \
 {                            \
   return x > y ? x : y;      \
 }
@@ -21,14 +39,26 @@ type fn(type x, type y)      \
 void* nuconv_memchr(const void* x, int y, size_t z)
 {
 #ifndef NUCONV_NO_STDLIB
-  return memchr(x, y, z);
+  return (void*)memchr(x, y, z);
 #else
   const uint8_t* a = (const uint8_t*)x;
-  for (; z != 0; --z) {
-    if (*a == (unsigned char)y) {
-      return a;
+  const uint8_t c = (uint8_t)y;
+  for (; z != 0 && ((uintptr_t)a & (2 * NUCONV_WSIZE - 1)) != 0; --z, ++a) {
+    if (*a == c) {
+      return (void*)a;
+    }
+  }
+  const nuconv_word pat = NUCONV_ONES * c;
+  for (; z >= 2 * NUCONV_WSIZE; z -= 2 * NUCONV_WSIZE, a += 2 * NUCONV_WSIZE) {
+    const nuconv_word* w = (const nuconv_word*)a;
+    if (NUCONV_HASZERO(w[0] ^ pat) | NUCONV_HASZERO(w[1] ^ pat)) {
+      break;
+    }
+  }
+  for (; z != 0; --z, ++a) {
+    if (*a == c) {
+      return (void*)a;
     }
-    ++a;
   }
   return NULL;
 #endif
@@ -39,8 +69,19 @@ int nuconv_memcmp(const char* x, const char* y, size_t z)
 #ifndef NUCONV_NO_STDLIB
   return memcmp(x, y, z);
 #else
-  for (; z != 0 && *x == *y; ++x, ++y, --z);
-  return ((int)*(uint8_t*)x) - ((int)*(uint8_t*)y);
+  for (; z >= NUCONV_WSIZE; z -= NUCONV_WSIZE) {
+    if (nuconv_loadw(x) != nuconv_loadw(y)) {
+      break;
+    }
+    x += NUCONV_WSIZE;
+    y += NUCONV_WSIZE;
+  }
+  for (; z != 0; --z, ++x, ++y) {
+    if (*x != *y) {
+      return ((int)*(const uint8_t*)x) - ((int)*(const uint8_t*)y);
+    }
+  }
+  return 0;
 #endif
 }
 
@@ -51,26 +92,149 @@ void* nuconv_memcpy(void* dst, const void* src, size_t z)
 #else
   uint8_t* d = (uint8_t*)dst;
   const uint8_t* s = (const uint8_t*)src;
+  for (; z != 0 && !NUCONV_ALIGNED(d); --z) {
+    *d++ = *s++;
+  }
+  for (; z >= 4 * NUCONV_WSIZE; z -= 4 * NUCONV_WSIZE) {
+    nuconv_word* w = (nuconv_word*)d;
+    w[0] = nuconv_loadw(s);
+    w[1] = nuconv_loadw(s + NUCONV_WSIZE);
+    w[2] = nuconv_loadw(s + 2 * NUCONV_WSIZE);
+    w[3] = nuconv_loadw(s + 3 * NUCONV_WSIZE);
+    d += 4 * NUCONV_WSIZE;
+    s += 4 * NUCONV_WSIZE;
+  }
+  for (; z >= NUCONV_WSIZE; z -= NUCONV_WSIZE) {
+    *(nuconv_word*)d = nuconv_loadw(s);
+    d += NUCONV_WSIZE;
+    s += NUCONV_WSIZE;
+  }
   for (; z != 0; --z) {
     *d++ = *s++;
   }
-  return d;
+  return dst;
 #endif
 }
 
+static inline size_t nuconv_maximal_suffix(const uint8_t* n, size_t l,
+                                           bool reverse, size_t* period)
+{
+  size_t i = (size_t)-1;
+  size_t j = 0;
+  size_t k = 1;
+  size_t p = 1;
+  while (j + k < l) {
+    const uint8_t a = n[i + k];
+    const uint8_t b = n[j + k];
+    if (a == b) {
+      if (k == p) {
+        j += p;
+        k = 1;
+      } else {
+        ++k;
+      }
+    } else if (reverse ? a < b : a > b) {
+      j += k;
+      k = 1;
+      p = j - i;
+    } else {
+      i = j++;
+      k = p = 1;
+    }
+  }
+  *period = p;
+  return i;
+}
+
+/* Crochemore-Perrin Two-Way search of n[0, l) in [h, z). When nul is set,
+   z is only a lower bound of the haystack end, which is found lazily at the
+   terminating NUL. */
+static uint8_t* nuconv_twoway(const uint8_t* h, const uint8_t* z,
+                              const uint8_t* n, size_t l, bool nul)
+{
+  size_t byteset[256 / (8 * sizeof(size_t))] = { 0 };
+  size_t shift[256];
+  size_t i, k, p, p0, ms, mem, mem0;
+  for (i = 0; i < l; ++i) {
+    byteset[n[i] / (8 * sizeof(size_t))] |= (size_t)1 << (n[i] % (8 * sizeof(size_t)));
+    shift[n[i]] = i + 1;
+  }
+  ms = nuconv_maximal_suffix(n, l, false, &p0);
+  i = nuconv_maximal_suffix(n, l, true, &p);
+  if (i + 1 > ms + 1) {
+    ms = i;
+  } else {
+    p = p0;
+  }
+  if (nuconv_memcmp((const char*)n, (const char*)n + p, ms + 1) != 0) {
+    mem0 = 0;
+    p = nuconv_zmax(ms, l - ms - 1) + 1;
+  } else {
+    mem0 = l - p;
+  }
+  mem = 0;
+  for (;;) {
+    if ((size_t)(z - h) < l) {
+      if (!nul) {
+        return NULL;
+      }
+      const size_t grow = l | 63;
+      const uint8_t* zz = (const uint8_t*)nuconv_memchr(z, 0, grow);
+      if (zz != NULL) {
+        z = zz;
+        if ((size_t)(z - h) < l) {
+          return NULL;
+        }
+      } else {
+        z += grow;
+      }
+    }
+    const uint8_t last = h[l - 1];
+    if ((byteset[last / (8 * sizeof(size_t))] >> (last % (8 * sizeof(size_t)))) & 1) {
+      k = l - shift[last];
+      if (k != 0) {
+        h += k < mem ? mem : k;
+        mem = 0;
+        continue;
+      }
+    } else {
+      h += l;
+      mem = 0;
+      continue;
+    }
+    for (k = nuconv_zmax(ms + 1, mem); k < l && n[k] == h[k]; ++k);
+    if (k < l) {
+      h += k - ms;
+      mem = 0;
+      continue;
+    }
+    for (k = ms + 1; k > mem && n[k - 1] == h[k - 1]; --k);
+    if (k <= mem) {
+      return (uint8_t*)h;
+    }
+    h += p;
+    mem = mem0;
+  }
+}
+
 void* nuconv_memmem(const void* haystack, size_t haystacklen,
                     const void* needle, size_t needlelen)
 {
-  if (needlelen > haystacklen || haystacklen < needlelen) {
+  const uint8_t* h = (const uint8_t*)haystack;
+  const uint8_t* n = (const uint8_t*)needle;
+  if (needlelen == 0) {
+    return (void*)h;
+  }
+  if (needlelen > haystacklen) {
     return NULL;
   }
-  size_t i, j;
-  for (i = 0, j = haystacklen-needlelen; i < j; ++i) {
-    if (nuconv_memcmp((const char*)(((uint8_t*)haystack) + i), needle, needlelen) == 0) {
-      return ((uint8_t*)haystack) + i;
-    }
+  if (needlelen == 1) {
+    return nuconv_memchr(h, n[0], haystacklen);
   }
-  return NULL;
+  if (nuconv_kernels.memmem != NULL && needlelen <= NUCONV_MEMMEM_SHORT) {
+    return nuconv_kernels.memmem(h, haystacklen, n, needlelen);
+  }
+  return nuconv_twoway(h, h + haystacklen, n, needlelen, false);
 }
 
 void* nuconv_memmove(void* dst, const void* src, size_t z)
@@ -89,8 +253,20 @@ void* nuconv_memmove(void* dst, const void* src, size_t z)
 
 size_t nuconv_memrev(char* buf, size_t n)
 {
-  size_t i;
-  for (i = 0; i < n/2; ++i) {
+  size_t i = 0;
+  if (nuconv_kernels.memrev != NULL) {
+    i = nuconv_kernels.memrev(buf, n);
+  }
+  for (; n - 2 * i >= 16; i += 8) {
+    uint64_t x, y;
+    __builtin_memcpy(&x, buf + i, 8);
+    __builtin_memcpy(&y, buf + n - i - 8, 8);
+    x = __builtin_bswap64(x);
+    y = __builtin_bswap64(y);
+    __builtin_memcpy(buf + i, &y, 8);
+    __builtin_memcpy(buf + n - i - 8, &x, 8);
+  }
+  for (; i < n/2; ++i) {
     const char x = buf[i];
     buf[i] = buf[n - i - 1];
     buf[n - i - 1] = x;
@@ -103,8 +279,26 @@ void* nuconv_memset(char* x, int y, size_t z)
 #ifndef NUCONV_NO_STDLIB
   return memset(x, y, z);
 #else
-  for (; z != 0; --z)
-    *x++ = (unsigned char)y;
+  char* d = x;
+  for (; z != 0 && !NUCONV_ALIGNED(d); --z) {
+    *d++ = (char)y;
+  }
+  const nuconv_word pat = NUCONV_ONES * (uint8_t)y;
+  for (; z >= 4 * NUCONV_WSIZE; z -= 4 * NUCONV_WSIZE) {
+    nuconv_word* w = (nuconv_word*)d;
+    w[0] = pat;
+    w[1] = pat;
+    w[2] = pat;
+    w[3] = pat;
+    d += 4 * NUCONV_WSIZE;
+  }
+  for (; z >= NUCONV_WSIZE; z -= NUCONV_WSIZE) {
+    *(nuconv_word*)d = pat;
+    d += NUCONV_WSIZE;
+  }
+  for (; z != 0; --z) {
+    *d++ = (char)y;
+  }
   return x;
 #endif
 }
@@ -112,14 +306,14 @@ void* nuconv_memset(char* x, int y, size_t z)
 char* nuconv_strchr(const char* str, int ch)
 {
 #ifndef NUCONV_NO_STDLIB
-  return strchr(str, ch);
+  return (char*)strchr(str, ch);
 #else
   if (ch == '\0') {
-    return nuconv_strlen(str);
+    return (char*)str + nuconv_strlen(str);
   }
   for (;;) {
-    if (*str == ch) {
-      return str;
+    if (*str == (char)ch) {
+      return (char*)str;
     }
     if (*str == '\0') {
       break;
@@ -135,7 +329,7 @@ int nuconv_strcmp(const char* x, const char* y)
 #ifndef NUCONV_NO_STDLIB
   return strcmp(x, y);
 #else
-  return nuconv_memcmp(x, y, nuconv_zmax(nuconv_strlen(x), nuconv_strlen(y)));
+  return nuconv_memcmp(x, y, nuconv_zmin(nuconv_strlen(x), nuconv_strlen(y)) + 1);
 #endif
 }
 
@@ -151,22 +345,31 @@ char* nuconv_strcpy(char* dst, const char* src)
 #endif
 }
 
+NUCONV_NO_ASAN
 size_t nuconv_strlen(const char* str)
 {
 #ifndef NUCONV_NO_STDLIB
   return strlen(str);
 #else
-  size_t n = 0;
-  while (*str++) {
-    ++n;
+  const char* s = str;
+  for (; ((uintptr_t)s & (2 * NUCONV_WSIZE - 1)) != 0; ++s) {
+    if (*s == '\0') {
+      return (size_t)(s - str);
+    }
   }
-  return n;
+  /* Aligned pairs of words never cross a page boundary. */
+  const nuconv_word* w = (const nuconv_word*)s;
+  while (!(NUCONV_HASZERO(w[0]) | NUCONV_HASZERO(w[1]))) {
+    w += 2;
+  }
+  for (s = (const char*)w; *s != '\0'; ++s);
+  return (size_t)(s - str);
 #endif
 }
 
 char* nuconv_strmove(char* dst, const char* src)
 {
-  return nuconv_memmove(dst, src, nuconv_strlen(src));
+  return (char*)nuconv_memmove(dst, src, nuconv_strlen(src));
 }
 
 size_t nuconv_strrev(char* str)
@@ -176,19 +379,30 @@ size_t nuconv_strrev(char* str)
 
 char* nuconv_strset(char* x, int y)
 {
-  return nuconv_memset(x, y, nuconv_strlen(x));
+  return (char*)nuconv_memset(x, y, nuconv_strlen(x));
 }
 
 char* nuconv_strstr(const char* haystack,
                     const char* needle)
 {
-  return nuconv_memmem(
-    haystack, nuconv_strlen(haystack),
-    needle, nuconv_strlen(needle)
-  );
+  if (needle[0] == '\0') {
+    return (char*)haystack;
+  }
+  const uint8_t* h = (const uint8_t*)nuconv_strchr(haystack, needle[0]);
+  if (h == NULL || needle[1] == '\0') {
+    return (char*)h;
+  }
+  size_t l;
+  for (l = 1; needle[l] != '\0'; ++l) {
+    if (h[l] == '\0') {
+      return NULL;
+    }
+  }
+  return (char*)nuconv_twoway(h, h + l, (const uint8_t*)needle, l, true);
 }
 
-uint16_t nuconv_ctype[] = {
+__attribute__((aligned(64)))
+const uint16_t nuconv_ctype[256] = {
   NUCONV_CNTRL,                                                                             /* 0x00 NUL   */
   NUCONV_CNTRL,                                                                             /* 0x01 SOH   */
   NUCONV_CNTRL,                                                                             /* 0x02 STX   */
@@ -318,6 +532,15 @@ uint16_t nuconv_ctype[] = {
   NUCONV_PRINT | NUCONV_GRAPH | NUCONV_PUNCT,                                               /* 0x7E '~'  */
   NUCONV_CNTRL,                                                                             /* 0x7F DEL  */
   NUCONV_NONE,                                                                              /* 0x80 */
+  NUCONV_NONE,                                                                              /* 0x81 */
+  NUCONV_NONE,                                                                              /* 0x82 */
+  NUCONV_NONE,                                                                              /* 0x83 */
+  NUCONV_NONE,                                                                              /* 0x84 */
+  NUCONV_NONE,                                                                              /* 0x85 */
+  NUCONV_NONE,                                                                              /* 0x86 */
+  NUCONV_NONE,                                                                              /* 0x87 */
+  NUCONV_NONE,                                                                              /* 0x88 */
+  NUCONV_NONE,                                                                              /* 0x89 */
   NUCONV_NONE,                                                                              /* 0x8A */
   NUCONV_NONE,                                                                              /* 0x8B */
   NUCONV_NONE,                                                                              /* 0x8C */
@@ -438,177 +661,454 @@ uint16_t nuconv_ctype[] = {
   NUCONV_NONE                                                                               /* 0xFF */
 };
 
-int nuconv_isalnum(int c)
+#define NUCONV_DV_SKIP    (0x40)
+#define NUCONV_DV_MINUS   (0x41)
+#define NUCONV_DV_DELIM   (0x42)
+#define NUCONV_DV_INVALID (0xFF)
+
+#define SK NUCONV_DV_SKIP
+#define MI NUCONV_DV_MINUS
+#define XX NUCONV_DV_INVALID
+static const uint8_t nuconv_digitval[256] = {
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, SK, SK, SK, SK, SK, XX, XX, /* 0x00 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0x10 */
+  SK, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, SK, XX, MI, XX, XX, /* 0x20 */
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX, /* 0x30 */
+  XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, /* 0x40 */
+  25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, SK, /* 0x50 */
+  XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, /* 0x60 */
+  25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX, /* 0x70 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0x80 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0x90 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0xA0 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0xB0 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0xC0 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0xD0 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, /* 0xE0 */
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX  /* 0xF0 */
+};
+#undef SK
+#undef MI
+#undef XX
+
+int (nuconv_isalnum)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isalnum(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_ALNUM) != 0;
-#endif
+  return nuconv_isalnum(c);
 }
 
-int nuconv_isalpha(int c)
+int (nuconv_isalpha)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isalpha(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_ALPHA) != 0;
-#endif
+  return nuconv_isalpha(c);
 }
 
-int nuconv_islower(int c)
+int (nuconv_islower)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return islower(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_LOWER) != 0;
-#endif
+  return nuconv_islower(c);
 }
 
-int nuconv_isupper(int c)
+int (nuconv_isupper)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isupper(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_UPPER) != 0;
-#endif
+  return nuconv_isupper(c);
 }
 
-int nuconv_isdigit(int c)
+int (nuconv_isdigit)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isdigit(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_DIGIT) != 0;
-#endif
+  return nuconv_isdigit(c);
 }
 
-int nuconv_isxdigit(int c)
+int (nuconv_isxdigit)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isxdigit(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_XDIGIT) != 0;
-#endif
+  return nuconv_isxdigit(c);
 }
 
-int nuconv_iscntrl(int c)
+int (nuconv_iscntrl)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return iscntrl(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_CNTRL) != 0;
-#endif
+  return nuconv_iscntrl(c);
 }
 
-int nuconv_isgraph(int c)
+int (nuconv_isgraph)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isgraph(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_GRAPH) != 0;
-#endif
+  return nuconv_isgraph(c);
 }
 
-int nuconv_isspace(int c)
+int (nuconv_isspace)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isspace(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_SPACE) != 0;
-#endif
+  return nuconv_isspace(c);
 }
 
-int nuconv_isblank(int c)
+int (nuconv_isblank)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isblank(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_BLANK) != 0;
-#endif
+  return nuconv_isblank(c);
 }
 
-int nuconv_isprint(int c)
+int (nuconv_isprint)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return isprint(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_PRINT) != 0;
-#endif
+  return nuconv_isprint(c);
 }
 
-int nuconv_ispunct(int c)
+int (nuconv_ispunct)(int c)
 {
-#ifndef NUCONV_NO_STDLIB
-  return ispunct(c);
-#else
-  return (nuconv_ctype[(unsigned char)c] & NUCONV_PUNCT) != 0;
-#endif
+  return nuconv_ispunct(c);
+}
+
+/* Builds the nibble lookup used by the vector classifiers: byte c belongs to
+   the classes in mask iff lut[c & 15] & lut[16 + (c >> 4)] is non-zero. Fails
+   when the rows of the class table need more than 8 buckets. */
+static bool nuconv_class_lut(int mask, uint8_t lut[32])
+{
+  uint16_t rows[8];
+  unsigned buckets = 0;
+  nuconv_memset((char*)lut, 0, 32);
+  for (unsigned h = 0; h < 16; ++h) {
+    uint16_t row = 0;
+    for (unsigned l = 0; l < 16; ++l) {
+      if ((nuconv_ctype[h * 16 + l] & mask) != 0) {
+        row |= (uint16_t)(1u << l);
+      }
+    }
+    if (row == 0) {
+      continue;
+    }
+    unsigned b;
+    for (b = 0; b < buckets && rows[b] != row; ++b);
+    if (b == buckets) {
+      if (buckets == 8) {
+        return false;
+      }
+      rows[buckets++] = row;
+    }
+    lut[16 + h] |= (uint8_t)(1u << b);
+  }
+  for (unsigned b = 0; b < buckets; ++b) {
+    for (unsigned l = 0; l < 16; ++l) {
+      if ((rows[b] >> l) & 1) {
+        lut[l] |= (uint8_t)(1u << b);
+      }
+    }
+  }
+  return true;
 }
 
+static inline size_t nuconv_do_span(const char* buf, size_t n, int mask,
+                                    bool accept)
+{
+  size_t i = 0;
+  uint8_t lut[32];
+  if (nuconv_kernels.span != NULL && n >= 32 && nuconv_class_lut(mask, lut)) {
+    i = nuconv_kernels.span(buf, n, lut, accept);
+  }
+  for (; i < n; ++i) {
+    if (((nuconv_ctype[(unsigned char)buf[i]] & mask) != 0) != accept) {
+      break;
+    }
+  }
+  return i;
+}
 
-int nuconv_tolower(int c)
+size_t nuconv_memspn(const char* buf, size_t n, int mask)
 {
-#ifndef NUCONV_NO_STDLIB
-  return tolower(c);
-#else
-  return nuconv_isupper(c)
-    ? c - 'a' + 'A'
-    : c;
-#endif
+  return nuconv_do_span(buf, n, mask, true);
 }
 
-int nuconv_toupper(int c)
+size_t nuconv_memcspn(const char* buf, size_t n, int mask)
 {
-#ifndef NUCONV_NO_STDLIB
-  return toupper(c);
-#else
-  return nuconv_islower(c)
-    ? c - 'A' + 'a'
-    : c;
-#endif
+  return nuconv_do_span(buf, n, mask, false);
+}
+
+void nuconv_memclass(const char* buf, size_t n, int mask, uint64_t* bits)
+{
+  size_t i = 0;
+  uint8_t lut[32];
+  if (nuconv_kernels.classify != NULL && n >= 64 && nuconv_class_lut(mask, lut)) {
+    i = nuconv_kernels.classify(buf, n, lut, bits);
+  }
+  for (; i < n; i += 64) {
+    uint64_t w = 0;
+    const size_t m = nuconv_zmin(n - i, 64);
+    for (size_t j = 0; j < m; ++j) {
+      if ((nuconv_ctype[(unsigned char)buf[i + j]] & mask) != 0) {
+        w |= (uint64_t)1 << j;
+      }
+    }
+    bits[i / 64] = w;
+  }
+}
+
+int (nuconv_tolower)(int c)
+{
+  return nuconv_tolower(c);
+}
+
+int (nuconv_toupper)(int c)
+{
+  return nuconv_toupper(c);
+}
+
+/* Flips bit 5 of every byte of w within [lo, hi]; bytes >= 0x80 are left
+   alone. */
+static inline uint64_t nuconv_swar_case(uint64_t w, uint8_t lo, uint8_t hi)
+{
+  const uint64_t ones = 0x0101010101010101ull;
+  const uint64_t h = w & 0x7F7F7F7F7F7F7F7Full;
+  const uint64_t ge = h + (0x80 - lo) * ones;
+  const uint64_t gt = h + (0x7F - hi) * ones;
+  return w ^ (((ge & ~gt & ~w) & 0x8080808080808080ull) >> 2);
+}
+
+static inline void nuconv_do_case(char* dst, const char* src, size_t n,
+                                  bool upper)
+{
+  const uint8_t lo = upper ? 'a' : 'A';
+  const uint8_t hi = upper ? 'z' : 'Z';
+  size_t i = 0;
+  if (nuconv_kernels.casecpy != NULL) {
+    i = nuconv_kernels.casecpy(dst, src, n, upper);
+  }
+  for (; i + 8 <= n; i += 8) {
+    uint64_t w;
+    __builtin_memcpy(&w, src + i, 8);
+    w = nuconv_swar_case(w, lo, hi);
+    __builtin_memcpy(dst + i, &w, 8);
+  }
+  for (; i < n; ++i) {
+    const uint8_t c = (uint8_t)src[i];
+    dst[i] = (char)((uint8_t)(c - lo) <= hi - lo ? c ^ 0x20 : c);
+  }
+}
+
+char* nuconv_memlower(char* buf, size_t n)
+{
+  nuconv_do_case(buf, buf, n, false);
+  return buf;
+}
+
+char* nuconv_memupper(char* buf, size_t n)
+{
+  nuconv_do_case(buf, buf, n, true);
+  return buf;
+}
+
+void* nuconv_memcpy_lower(void* dst, const void* src, size_t n)
+{
+  nuconv_do_case((char*)dst, (const char*)src, n, false);
+  return dst;
+}
+
+void* nuconv_memcpy_upper(void* dst, const void* src, size_t n)
+{
+  nuconv_do_case((char*)dst, (const char*)src, n, true);
+  return dst;
 }
 
 const char* const nuconv_alphabetu = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 const char* const nuconv_alphabetl = "0123456789abcdefghijklmnopqrstuvwxyz";
 
-int nuconv_do_atoi(int64_t* dst, const char* target, unsigned radix, int flags)
+static const uint64_t nuconv_pow10[20] = {
+  1ull,
+  10ull,
+  100ull,
+  1000ull,
+  10000ull,
+  100000ull,
+  1000000ull,
+  10000000ull,
+  100000000ull,
+  1000000000ull,
+  10000000000ull,
+  100000000000ull,
+  1000000000000ull,
+  10000000000000ull,
+  100000000000000ull,
+  1000000000000000ull,
+  10000000000000000ull,
+  100000000000000000ull,
+  1000000000000000000ull,
+  10000000000000000000ull
+};
+
+/* res = (res << bits) | val for val < 2^bits, reporting whether any set bit
+   was shifted out. */
+static inline bool nuconv_shl_overflow(uint64_t* res, unsigned bits, uint64_t val)
 {
-  int64_t res = 0;
-  bool looped = false;
-  bool sign = false;
-  bool succ = false;
-  bool overflow = false;
-  if (radix < 2 || radix > 36) {
-    return -NUCONV_ERROR_RADIX;
+  if (bits >= 64) {
+    const bool overflow = *res != 0;
+    *res = val;
+    return overflow;
   }
-  const char* ptr = target;
-  char c;
-  while ((c = *ptr++) != 0) {
-    if (c == '-') {
-      sign = true;
-      continue;
-    }
-    if (nuconv_strchr("\t\n\v\f\r +_", c) != NULL) {
-      continue;
+  const bool overflow = (*res >> (64 - bits)) != 0;
+  *res = (*res << bits) | val;
+  return overflow;
+}
+
+/* Accumulator of a field being parsed; carried between chunks by the
+   streaming parser. */
+struct nuconv_parse_state {
+  uint64_t res;
+  bool sign;
+  bool succ;
+  bool overflow;
+};
+
+/* Consumes digits, signs and skipped characters of [ptr, end) into st and
+   returns the first character it did not consume. */
+static inline const char* nuconv_parse_run(struct nuconv_parse_state* st,
+                                           const char* ptr, const char* end,
+                                           unsigned radix, bool sig,
+                                           const uint8_t* dv)
+{
+  uint64_t res  = st->res;
+  bool sign     = st->sign;
+  bool succ     = st->succ;
+  bool overflow = st->overflow;
+  const unsigned shift = (radix & (radix - 1)) == 0
+    ? (unsigned)__builtin_ctz(radix)
+    : 0;
+  while (ptr != end) {
+    if (radix == 10) {
+      unsigned n = 0;
+      unsigned width = 0;
+      uint64_t val[2];
+      if (nuconv_kernels.parse10 != NULL
+          && nuconv_can_load(ptr, end, nuconv_kernels.parse10_width)) {
+        width = nuconv_kernels.parse10_width;
+        n = nuconv_kernels.parse10(ptr, val);
+      } else if (nuconv_can_load(ptr, end, 8)) {
+        uint64_t w = nuconv_load8(ptr);
+        width = 8;
+        n = nuconv_swar_digits(w);
+        if (n != 0 && n != 8) {
+          w = (w << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+        }
+        val[0] = nuconv_swar_parse8(w);
+      }
+      if (n != 0) {
+        const unsigned lo = n > 16 ? 16 : n;
+        succ = true;
+        overflow |= __builtin_mul_overflow(res, nuconv_pow10[lo], &res);
+        overflow |= __builtin_add_overflow(res, val[0], &res);
+        if (n > 16) {
+          overflow |= __builtin_mul_overflow(res, nuconv_pow10[n - 16], &res);
+          overflow |= __builtin_add_overflow(res, val[1], &res);
+        }
+        ptr += n;
+        if (n == width) {
+          continue;
+        }
+      }
+    } else if (radix == 16 && nuconv_kernels.parse16 != NULL
+               && nuconv_can_load(ptr, end, 16)) {
+      uint64_t val;
+      const unsigned n = nuconv_kernels.parse16(ptr, &val);
+      if (n != 0) {
+        succ = true;
+        overflow |= nuconv_shl_overflow(&res, 4 * n, val);
+        ptr += n;
+        if (n == 16) {
+          continue;
+        }
+      }
     }
-    looped = true;
-    char* x = nuconv_strchr(nuconv_alphabetu, nuconv_toupper(c));
-    if (x == NULL) {
+    const unsigned v = dv[(unsigned char)*ptr];
+    if (v < radix) {
+      succ = true;
+      if (shift != 0) {
+        overflow |= nuconv_shl_overflow(&res, shift, v);
+      } else {
+        overflow |= __builtin_mul_overflow(res, radix, &res);
+        overflow |= __builtin_add_overflow(res, v, &res);
+      }
+    } else if (v == NUCONV_DV_MINUS && sig) {
+      sign = true;
+    } else if (v != NUCONV_DV_SKIP) {
       break;
     }
-    size_t pos = x - nuconv_alphabetu;
-    if (pos >= radix) {
+    ++ptr;
+  }
+  st->res = res;
+  st->sign = sign;
+  st->succ = succ;
+  st->overflow = overflow;
+  return ptr;
+}
+
+static inline int nuconv_parse_result(const struct nuconv_parse_state* st,
+                                      uint64_t max, bool looped, uint64_t* dst)
+{
+  *dst = st->sign ? 0 - st->res : st->res;
+  return !st->succ
+    ? looped
+      ? -NUCONV_ERROR_INVALID_CHARACTER
+      : -NUCONV_ERROR_EMPTY
+    : st->overflow || st->res > max + st->sign
+      ? NUCONV_WARN_OVERFLOW
+      : NUCONV_OK;
+}
+
+static inline int nuconv_do_parse(uint64_t* dst, const char* ptr, const char* end,
+                                  const char** stop, unsigned radix, bool sig,
+                                  uint64_t max, const uint8_t* dv)
+{
+  struct nuconv_parse_state st = {0, false, false, false};
+  ptr = nuconv_parse_run(&st, ptr, end, radix, sig, dv);
+  const bool looped = ptr != end
+    && dv[(unsigned char)*ptr] != NUCONV_DV_DELIM
+    && (end != NULL || *ptr != '\0');
+  if (stop != NULL) {
+    *stop = ptr;
+  }
+  return nuconv_parse_result(&st, max, looped, dst);
+}
+
+/* Parser for targets of at most 32 bits. The accumulator is clamped to
+   max + 2, just past the largest magnitude either sign accepts, so it stays
+   below 2^33 and the multiply-adds need no overflow check. dst receives the
+   value saturated to [-(max + 1), max]. */
+static inline int nuconv_parse_narrow(uint64_t* dst, const char* ptr,
+                                      const char* end, const char** stop,
+                                      unsigned radix, bool sig, uint32_t max)
+{
+  const uint64_t cap = (uint64_t)max + 2;
+  uint64_t res = 0;
+  bool sign    = false;
+  bool succ    = false;
+  while (ptr != end) {
+    if (radix == 10 && nuconv_can_load(ptr, end, 8)) {
+      uint64_t w = nuconv_load8(ptr);
+      const unsigned n = nuconv_swar_digits(w);
+      if (n != 0) {
+        if (n != 8) {
+          w = (w << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+        }
+        succ = true;
+        res = res * nuconv_pow10[n] + nuconv_swar_parse8(w);
+        res = res > cap ? cap : res;
+        ptr += n;
+        if (n == 8) {
+          continue;
+        }
+      }
+    }
+    const unsigned v = nuconv_digitval[(unsigned char)*ptr];
+    if (v < radix) {
+      succ = true;
+      res = res * radix + v;
+      res = res > cap ? cap : res;
+    } else if (v == NUCONV_DV_MINUS && sig) {
+      sign = true;
+    } else if (v != NUCONV_DV_SKIP) {
       break;
     }
-    succ = true;
-    overflow = __builtin_mul_overflow(res, radix, &res) || overflow;
-    overflow = __builtin_add_overflow(res, pos, &res) || overflow;
+    ++ptr;
   }
-  if (sign) {
-    res = -res;
+  const bool looped = ptr != end && (end != NULL || *ptr != '\0');
+  if (stop != NULL) {
+    *stop = ptr;
   }
-  *dst = res;
+  const bool overflow = res > (uint64_t)max + sign;
+  if (overflow) {
+    res = (uint64_t)max + sign;
+  }
+  *dst = sign ? 0 - res : res;
   return !succ
     ? looped
       ? -NUCONV_ERROR_INVALID_CHARACTER
@@ -618,35 +1118,611 @@ int nuconv_do_atoi(int64_t* dst, const char* target, unsigned radix, int flags)
       : NUCONV_OK;
 }
 
+int nuconv_do_atoin(int64_t* dst, const char* begin, const char* end,
+                    const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  if (radix < 2 || radix > 36) {
+    if (stop != NULL) {
+      *stop = begin;
+    }
+    return -NUCONV_ERROR_RADIX;
+  }
+  uint64_t res;
+  const int ret = nuconv_do_parse(&res, begin, end, stop, radix, true, INT64_MAX,
+                                  nuconv_digitval);
+  *dst = (int64_t)res;
+  return ret;
+}
+
+int nuconv_do_atoun(uint64_t* dst, const char* begin, const char* end,
+                    const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  if (radix < 2 || radix > 36) {
+    if (stop != NULL) {
+      *stop = begin;
+    }
+    return -NUCONV_ERROR_RADIX;
+  }
+  return nuconv_do_parse(dst, begin, end, stop, radix, false, UINT64_MAX,
+                         nuconv_digitval);
+}
+
+int nuconv_do_atoi(int64_t* dst, const char* target, unsigned radix, int flags)
+{
+  return nuconv_do_atoin(dst, target, NULL, NULL, radix, flags);
+}
+
 int nuconv_do_atou(uint64_t* dst, const char* target, unsigned radix, int flags)
 {
-  uint64_t res  = 0;
-  bool looped   = false;
-  bool succ     = false;
-  bool overflow = false;
+  return nuconv_do_atoun(dst, target, NULL, NULL, radix, flags);
+}
+
+#define NUCONV_ATOI_NARROW(bits, max)                                         \
+int nuconv_do_atoi##bits(int##bits##_t* dst, const char* begin,               \
+                         const char* end, const char** stop, unsigned radix,  \
+                         int flags)                                           \
+{                                                                             \
+  (void)flags;                                                                \
+  uint64_t res = 0;                                                           \
+  int ret = -NUCONV_ERROR_RADIX;                                              \
+  if (radix >= 2 && radix <= 36) {                                            \
+    ret = nuconv_parse_narrow(&res, begin, end, stop, radix, true, max);      \
+  } else if (stop != NULL) {                                                  \
+    *stop = begin;                                                            \
+  }                                                                           \
+  *dst = (int##bits##_t)res;                                                  \
+  return ret;                                                                 \
+}
+
+#define NUCONV_ATOU_NARROW(bits, max)                                         \
+int nuconv_do_atou##bits(uint##bits##_t* dst, const char* begin,              \
+                         const char* end, const char** stop, unsigned radix,  \
+                         int flags)                                           \
+{                                                                             \
+  (void)flags;                                                                \
+  uint64_t res = 0;                                                           \
+  int ret = -NUCONV_ERROR_RADIX;                                              \
+  if (radix >= 2 && radix <= 36) {                                            \
+    ret = nuconv_parse_narrow(&res, begin, end, stop, radix, false, max);     \
+  } else if (stop != NULL) {                                                  \
+    *stop = begin;                                                            \
+  }                                                                           \
+  *dst = (uint##bits##_t)res;                                                 \
+  return ret;                                                                 \
+}
+
+NUCONV_ATOI_NARROW(8,  INT8_MAX)
+NUCONV_ATOI_NARROW(16, INT16_MAX)
+NUCONV_ATOI_NARROW(32, INT32_MAX)
+NUCONV_ATOU_NARROW(8,  UINT8_MAX)
+NUCONV_ATOU_NARROW(16, UINT16_MAX)
+NUCONV_ATOU_NARROW(32, UINT32_MAX)
+
+static int nuconv_parse_wide(uint64_t* dst, const char* begin, const char* end,
+                             const char** stop, unsigned radix, bool sig,
+                             uint64_t max)
+{
   if (radix < 2 || radix > 36) {
+    if (stop != NULL) {
+      *stop = begin;
+    }
+    *dst = 0;
     return -NUCONV_ERROR_RADIX;
   }
-  const char* ptr = target;
-  char c;
-  while ((c = *ptr++) != 0) {
-    if (nuconv_strchr("\t\n\v\f\r +_", c) != NULL) {
-      continue;
+  struct nuconv_parse_state st = {0, false, false, false};
+  const char* ptr = nuconv_parse_run(&st, begin, end, radix, sig,
+                                     nuconv_digitval);
+  const bool looped = ptr != end && (end != NULL || *ptr != '\0');
+  if (stop != NULL) {
+    *stop = ptr;
+  }
+  const int ret = nuconv_parse_result(&st, max, looped, dst);
+  if (ret == NUCONV_WARN_OVERFLOW) {
+    *dst = st.sign ? 0 - (max + 1) : max;
+  }
+  return ret;
+}
+
+int nuconv_do_atoi64(int64_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  uint64_t res;
+  const int ret = nuconv_parse_wide(&res, begin, end, stop, radix, true,
+                                    INT64_MAX);
+  *dst = (int64_t)res;
+  return ret;
+}
+
+int nuconv_do_atou64(uint64_t* dst, const char* begin, const char* end,
+                     const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  return nuconv_parse_wide(dst, begin, end, stop, radix, false, UINT64_MAX);
+}
+
+/* Digit values with the characters of delims that are not digits of radix
+   marked as field delimiters. */
+static void nuconv_delim_table(uint8_t* dv, const char* delims, unsigned radix)
+{
+  nuconv_memcpy(dv, nuconv_digitval, 256);
+  for (; *delims != '\0'; ++delims) {
+    if (dv[(unsigned char)*delims] >= radix) {
+      dv[(unsigned char)*delims] = NUCONV_DV_DELIM;
+    }
+  }
+}
+
+static int nuconv_do_bulk(uint64_t* dst, int* status, size_t* count,
+                          const char* begin, const char* end,
+                          const char** stop, const char* delims,
+                          unsigned radix, bool sig, uint64_t max)
+{
+  uint8_t dv[256];
+  int ret = NUCONV_OK;
+  size_t i;
+  if (radix < 2 || radix > 36) {
+    *count = 0;
+    if (stop != NULL) {
+      *stop = begin;
+    }
+    return -NUCONV_ERROR_RADIX;
+  }
+  if (end == NULL) {
+    end = begin + nuconv_strlen(begin);
+  }
+  nuconv_delim_table(dv, delims, radix);
+  const char* ptr = begin;
+  for (i = 0; i < *count && ptr != end; ++i) {
+    const int r = nuconv_do_parse(&dst[i], ptr, end, &ptr, radix, sig, max, dv);
+    while (ptr != end && dv[(unsigned char)*ptr] != NUCONV_DV_DELIM) {
+      ++ptr;
+    }
+    if (ptr != end) {
+      ++ptr;
+    }
+    if (status != NULL) {
+      status[i] = r;
+    }
+    if (ret == NUCONV_OK) {
+      ret = r;
     }
-    looped = true;
-    char* x = nuconv_strchr(nuconv_alphabetu, nuconv_toupper(c));
-    if (x == NULL) {
+  }
+  *count = i;
+  if (stop != NULL) {
+    *stop = ptr;
+  }
+  return ret;
+}
+
+int nuconv_do_atoi_bulk(int64_t* dst, int* status, size_t* count,
+                        const char* begin, const char* end, const char** stop,
+                        const char* delims, unsigned radix, int flags)
+{
+  (void)flags;
+  return nuconv_do_bulk((uint64_t*)dst, status, count, begin, end, stop,
+                        delims, radix, true, INT64_MAX);
+}
+
+int nuconv_do_atou_bulk(uint64_t* dst, int* status, size_t* count,
+                        const char* begin, const char* end, const char** stop,
+                        const char* delims, unsigned radix, int flags)
+{
+  (void)flags;
+  return nuconv_do_bulk(dst, status, count, begin, end, stop,
+                        delims, radix, false, UINT64_MAX);
+}
+
+int nuconv_stream_init(struct nuconv_stream* s, const char* delims,
+                       unsigned radix, int flags)
+{
+  (void)flags;
+  if (radix < 2 || radix > 36) {
+    return -NUCONV_ERROR_RADIX;
+  }
+  s->acc = 0;
+  s->radix = radix;
+  s->sign = s->succ = s->overflow = s->skipping = s->pending = 0;
+  nuconv_delim_table(s->dv, delims, radix);
+  return NUCONV_OK;
+}
+
+static inline void nuconv_stream_reset(struct nuconv_stream* s)
+{
+  s->acc = 0;
+  s->sign = s->succ = s->overflow = s->skipping = s->pending = 0;
+}
+
+static int nuconv_stream_feed(struct nuconv_stream* s, uint64_t* dst,
+                              int* status, size_t* count,
+                              const char* begin, const char* end,
+                              const char** stop, bool sig, uint64_t max)
+{
+  const uint8_t* dv = s->dv;
+  if (end == NULL) {
+    end = begin + nuconv_strlen(begin);
+  }
+  struct nuconv_parse_state st = {s->acc, s->sign != 0, s->succ != 0,
+                                  s->overflow != 0};
+  const char* ptr = begin;
+  int ret = NUCONV_OK;
+  size_t i = 0;
+  while (i < *count && ptr != end) {
+    const char* field = ptr;
+    if (!s->skipping) {
+      ptr = nuconv_parse_run(&st, ptr, end, s->radix, sig, dv);
+      if (ptr != end && dv[(unsigned char)*ptr] != NUCONV_DV_DELIM) {
+        s->skipping = 1;
+      }
+    }
+    while (ptr != end && dv[(unsigned char)*ptr] != NUCONV_DV_DELIM) {
+      ++ptr;
+    }
+    if (ptr == end) {
+      s->pending |= ptr != field;
       break;
     }
-    size_t pos = x - nuconv_alphabetu;
-    if (pos >= radix) {
+    ++ptr;
+    const int r = nuconv_parse_result(&st, max, s->skipping, &dst[i]);
+    if (status != NULL) {
+      status[i] = r;
+    }
+    if (ret == NUCONV_OK) {
+      ret = r;
+    }
+    ++i;
+    st.res = 0;
+    st.sign = st.succ = st.overflow = false;
+    s->skipping = s->pending = 0;
+  }
+  s->acc = st.res;
+  s->sign = st.sign;
+  s->succ = st.succ;
+  s->overflow = st.overflow;
+  *count = i;
+  if (stop != NULL) {
+    *stop = ptr;
+  }
+  return ret;
+}
+
+static int nuconv_stream_finish(struct nuconv_stream* s, uint64_t* dst,
+                                size_t* count, uint64_t max)
+{
+  const struct nuconv_parse_state st = {s->acc, s->sign != 0, s->succ != 0,
+                                        s->overflow != 0};
+  const bool pending = s->pending;
+  const bool looped = s->skipping;
+  nuconv_stream_reset(s);
+  *count = pending;
+  if (!pending) {
+    return NUCONV_OK;
+  }
+  return nuconv_parse_result(&st, max, looped, dst);
+}
+
+int nuconv_stream_feedi(struct nuconv_stream* s, int64_t* dst, int* status,
+                        size_t* count, const char* begin, const char* end,
+                        const char** stop)
+{
+  return nuconv_stream_feed(s, (uint64_t*)dst, status, count, begin, end, stop,
+                            true, INT64_MAX);
+}
+
+int nuconv_stream_feedu(struct nuconv_stream* s, uint64_t* dst, int* status,
+                        size_t* count, const char* begin, const char* end,
+                        const char** stop)
+{
+  return nuconv_stream_feed(s, dst, status, count, begin, end, stop,
+                            false, UINT64_MAX);
+}
+
+int nuconv_stream_finishi(struct nuconv_stream* s, int64_t* dst,
+                          size_t* count)
+{
+  return nuconv_stream_finish(s, (uint64_t*)dst, count, INT64_MAX);
+}
+
+int nuconv_stream_finishu(struct nuconv_stream* s, uint64_t* dst,
+                          size_t* count)
+{
+  return nuconv_stream_finish(s, dst, count, UINT64_MAX);
+}
+
+static const char nuconv_digits2[] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static inline unsigned nuconv_udigits(uint64_t target, unsigned radix)
+{
+  const unsigned bits = 64 - (unsigned)__builtin_clzll(target | 1);
+  if (radix == 10) {
+    const unsigned t = (bits * 1233) >> 12;
+    return t + ((target | 1) >= nuconv_pow10[t]);
+  }
+  if ((radix & (radix - 1)) == 0) {
+    const unsigned shift = (unsigned)__builtin_ctz(radix);
+    return (bits + shift - 1) / shift;
+  }
+  unsigned n = 1;
+  while (target >= radix) {
+    target /= radix;
+    ++n;
+  }
+  return n;
+}
+
+/* Writes the digits of target so that the last one lands at end[-1]. */
+static inline void nuconv_write_digits(char* end, uint64_t target,
+                                       unsigned radix, int flags)
+{
+  if (radix == 10) {
+    while (target >= 100) {
+      const uint64_t q = target / 100;
+      end -= 2;
+      nuconv_memcpy(end, nuconv_digits2 + (target - q * 100) * 2, 2);
+      target = q;
+    }
+    if (target >= 10) {
+      nuconv_memcpy(end - 2, nuconv_digits2 + target * 2, 2);
+    } else {
+      end[-1] = (char)('0' + target);
+    }
+    return;
+  }
+  const char* alphabet = (flags & NUCONV_FLAG_UPPERCASE) != 0
+    ? nuconv_alphabetu
+    : nuconv_alphabetl;
+  if (radix == 16 && nuconv_kernels.format16 != NULL) {
+    char tmp[16];
+    const unsigned n = nuconv_udigits(target, 16);
+    nuconv_kernels.format16(target, tmp, alphabet);
+    nuconv_memcpy(end - n, tmp + 16 - n, n);
+    return;
+  }
+  if ((radix & (radix - 1)) == 0) {
+    const unsigned shift = (unsigned)__builtin_ctz(radix);
+    do {
+      *--end = alphabet[target & (radix - 1)];
+    } while (target >>= shift);
+    return;
+  }
+  do {
+    *--end = alphabet[target % radix];
+  } while (target /= radix);
+}
+
+size_t nuconv_utoa_len(uint64_t target, unsigned radix)
+{
+  if (radix < 2 || radix > 36) {
+    return 0;
+  }
+  return nuconv_udigits(target, radix);
+}
+
+size_t nuconv_itoa_len(int64_t target, unsigned radix, int flags)
+{
+  if (radix < 2 || radix > 36) {
+    return 0;
+  }
+  const uint64_t mag = target < 0 ? 0 - (uint64_t)target : (uint64_t)target;
+  return nuconv_udigits(mag, radix)
+    + (target < 0 && (flags & NUCONV_FLAG_ABS) == 0);
+}
+
+int nuconv_do_itoa(int64_t target, char* buf, unsigned radix, int flags)
+{
+  if (radix < 2 || radix > 36) {
+    return -NUCONV_ERROR_RADIX;
+  }
+  const bool sign = target < 0 && (flags & NUCONV_FLAG_ABS) == 0;
+  const uint64_t mag = target < 0 ? 0 - (uint64_t)target : (uint64_t)target;
+  const unsigned len = nuconv_udigits(mag, radix) + sign;
+  if (sign) {
+    *buf = '-';
+  }
+  nuconv_write_digits(buf + len, mag, radix, flags);
+  buf[len] = '\0';
+  return (int)len;
+}
+
+int nuconv_do_utoa(uint64_t target, char* buf, unsigned radix, int flags)
+{
+  if (radix < 2 || radix > 36) {
+    return -NUCONV_ERROR_RADIX;
+  }
+  const unsigned len = nuconv_udigits(target, radix);
+  nuconv_write_digits(buf + len, target, radix, flags);
+  buf[len] = '\0';
+  return (int)len;
+}
+
+static const uint32_t nuconv_pow10_32[10] = {
+  1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u,
+  1000000000u
+};
+
+/* 32-bit counterparts of nuconv_udigits/nuconv_write_digits: digit counts
+   come from the 32-bit power table and divisions by non-power-of-two radixes
+   are 32-bit. */
+static inline unsigned nuconv_udigits32(uint32_t target, unsigned radix)
+{
+  if (radix == 10) {
+    const unsigned bits = 32 - (unsigned)__builtin_clz(target | 1);
+    const unsigned t = (bits * 1233) >> 12;
+    return t + ((target | 1) >= nuconv_pow10_32[t]);
+  }
+  if ((radix & (radix - 1)) == 0) {
+    return nuconv_udigits(target, radix);
+  }
+  unsigned n = 1;
+  while (target >= radix) {
+    target /= radix;
+    ++n;
+  }
+  return n;
+}
+
+static inline void nuconv_write_digits32(char* end, uint32_t target,
+                                         unsigned radix, int flags)
+{
+  if (radix == 10) {
+    while (target >= 100) {
+      const uint32_t q = target / 100;
+      end -= 2;
+      nuconv_memcpy(end, nuconv_digits2 + (target - q * 100) * 2, 2);
+      target = q;
+    }
+    if (target >= 10) {
+      nuconv_memcpy(end - 2, nuconv_digits2 + target * 2, 2);
+    } else {
+      end[-1] = (char)('0' + target);
+    }
+    return;
+  }
+  if ((radix & (radix - 1)) == 0) {
+    nuconv_write_digits(end, target, radix, flags);
+    return;
+  }
+  const char* alphabet = (flags & NUCONV_FLAG_UPPERCASE) != 0
+    ? nuconv_alphabetu
+    : nuconv_alphabetl;
+  do {
+    *--end = alphabet[target % radix];
+  } while (target /= radix);
+}
+
+static int nuconv_format32(uint32_t mag, bool sign, char* buf, unsigned radix,
+                           int flags)
+{
+  if (radix < 2 || radix > 36) {
+    return -NUCONV_ERROR_RADIX;
+  }
+  sign = sign && (flags & NUCONV_FLAG_ABS) == 0;
+  const unsigned len = nuconv_udigits32(mag, radix) + sign;
+  if (sign) {
+    *buf = '-';
+  }
+  nuconv_write_digits32(buf + len, mag, radix, flags);
+  buf[len] = '\0';
+  return (int)len;
+}
+
+int nuconv_do_itoa8(int8_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_do_itoa32(target, buf, radix, flags);
+}
+
+int nuconv_do_itoa16(int16_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_do_itoa32(target, buf, radix, flags);
+}
+
+int nuconv_do_itoa32(int32_t target, char* buf, unsigned radix, int flags)
+{
+  const uint32_t mag = target < 0 ? 0 - (uint32_t)target : (uint32_t)target;
+  return nuconv_format32(mag, target < 0, buf, radix, flags);
+}
+
+int nuconv_do_itoa64(int64_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_do_itoa(target, buf, radix, flags);
+}
+
+int nuconv_do_utoa8(uint8_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_format32(target, false, buf, radix, flags);
+}
+
+int nuconv_do_utoa16(uint16_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_format32(target, false, buf, radix, flags);
+}
+
+int nuconv_do_utoa32(uint32_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_format32(target, false, buf, radix, flags);
+}
+
+int nuconv_do_utoa64(uint64_t target, char* buf, unsigned radix, int flags)
+{
+  return nuconv_do_utoa(target, buf, radix, flags);
+}
+
+#ifdef __SIZEOF_INT128__
+/* Digits are gathered into a 64-bit chunk while radix^digits still fits in
+   64 bits (19 decimal digits) and folded into the 128-bit accumulator with a
+   single multiply-add, so the 128-bit arithmetic runs once per chunk. */
+static int nuconv_parse128(nuconv_uint128* dst, const char* ptr,
+                           const char* end, const char** stop, unsigned radix,
+                           bool sig, nuconv_uint128 max)
+{
+  if (radix < 2 || radix > 36) {
+    if (stop != NULL) {
+      *stop = ptr;
+    }
+    *dst = 0;
+    return -NUCONV_ERROR_RADIX;
+  }
+  const uint64_t limit = UINT64_MAX / radix;
+  nuconv_uint128 res = 0;
+  uint64_t chunk = 0;
+  uint64_t scale = 1;
+  bool sign      = false;
+  bool succ      = false;
+  bool overflow  = false;
+  while (ptr != end) {
+    if (radix == 10 && scale <= UINT64_MAX / 100000000u
+        && nuconv_can_load(ptr, end, 8)) {
+      uint64_t w = nuconv_load8(ptr);
+      const unsigned n = nuconv_swar_digits(w);
+      if (n != 0) {
+        if (n != 8) {
+          w = (w << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+        }
+        succ = true;
+        chunk = chunk * nuconv_pow10[n] + nuconv_swar_parse8(w);
+        scale *= nuconv_pow10[n];
+        ptr += n;
+        if (n == 8) {
+          continue;
+        }
+      }
+    }
+    const unsigned v = nuconv_digitval[(unsigned char)*ptr];
+    if (v < radix) {
+      if (scale > limit) {
+        overflow |= __builtin_mul_overflow(res, scale, &res);
+        overflow |= __builtin_add_overflow(res, chunk, &res);
+        chunk = 0;
+        scale = 1;
+      }
+      succ = true;
+      chunk = chunk * radix + v;
+      scale *= radix;
+    } else if (v == NUCONV_DV_MINUS && sig) {
+      sign = true;
+    } else if (v != NUCONV_DV_SKIP) {
       break;
     }
-    succ = true;
-    overflow = __builtin_mul_overflow(res, radix, &res) || overflow;
-    overflow = __builtin_add_overflow(res, pos, &res) || overflow;
+    ++ptr;
+  }
+  overflow |= __builtin_mul_overflow(res, scale, &res);
+  overflow |= __builtin_add_overflow(res, chunk, &res);
+  const bool looped = ptr != end && (end != NULL || *ptr != '\0');
+  if (stop != NULL) {
+    *stop = ptr;
+  }
+  overflow = overflow || res > max + sign;
+  if (overflow) {
+    res = max + sign;
   }
-  *dst = res;
+  *dst = sign ? 0 - res : res;
   return !succ
     ? looped
       ? -NUCONV_ERROR_INVALID_CHARACTER
@@ -656,77 +1732,204 @@ int nuconv_do_atou(uint64_t* dst, const char* target, unsigned radix, int flags)
       : NUCONV_OK;
 }
 
-int nuconv_do_itoa(int64_t target, char* buf, unsigned radix, int flags)
+int nuconv_do_atoi128(nuconv_int128* dst, const char* begin, const char* end,
+                      const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  nuconv_uint128 res;
+  const int ret = nuconv_parse128(&res, begin, end, stop, radix, true,
+                                  (nuconv_uint128)-1 >> 1);
+  *dst = (nuconv_int128)res;
+  return ret;
+}
+
+int nuconv_do_atou128(nuconv_uint128* dst, const char* begin, const char* end,
+                      const char** stop, unsigned radix, int flags)
+{
+  (void)flags;
+  return nuconv_parse128(dst, begin, end, stop, radix, false,
+                         (nuconv_uint128)-1);
+}
+
+/* Splits target into at most three 64-bit chunks of radix^k, the largest
+   power of radix that fits in 64 bits (10^19 for decimal), and formats each
+   with the 64-bit writer; only the two splitting divisions are 128-bit. */
+static int nuconv_format128(nuconv_uint128 target, bool sign, char* buf,
+                            unsigned radix, int flags)
+{
+  if (radix < 2 || radix > 36) {
+    return -NUCONV_ERROR_RADIX;
+  }
+  sign = sign && (flags & NUCONV_FLAG_ABS) == 0;
+  if ((target >> 64) == 0) {
+    if (sign) {
+      *buf = '-';
+    }
+    return nuconv_do_utoa((uint64_t)target, buf + sign, radix, flags) + sign;
+  }
+  uint64_t p = radix;
+  unsigned k = 1;
+  if (radix == 10) {
+    p = 10000000000000000000ull;
+    k = 19;
+  } else {
+    while (p <= UINT64_MAX / radix) {
+      p *= radix;
+      ++k;
+    }
+  }
+  uint64_t parts[3];
+  unsigned n = 0;
+  do {
+    parts[n++] = (uint64_t)(target % p);
+    target /= p;
+  } while (target != 0);
+
+  char* ptr = buf;
+  if (sign) {
+    *ptr++ = '-';
+  }
+  const unsigned lead = nuconv_udigits(parts[n - 1], radix);
+  nuconv_write_digits(ptr + lead, parts[n - 1], radix, flags);
+  ptr += lead;
+  while (--n != 0) {
+    nuconv_memset(ptr, '0', k);
+    nuconv_write_digits(ptr + k, parts[n - 1], radix, flags);
+    ptr += k;
+  }
+  *ptr = '\0';
+  return (int)(ptr - buf);
+}
+
+int nuconv_do_itoa128(nuconv_int128 target, char* buf, unsigned radix,
+                      int flags)
+{
+  const nuconv_uint128 mag = target < 0
+    ? 0 - (nuconv_uint128)target
+    : (nuconv_uint128)target;
+  return nuconv_format128(mag, target < 0, buf, radix, flags);
+}
+
+int nuconv_do_utoa128(nuconv_uint128 target, char* buf, unsigned radix,
+                      int flags)
+{
+  return nuconv_format128(target, false, buf, radix, flags);
+}
+#endif
+
+size_t nuconv_itoa_bulk_len(const int64_t* src, size_t count, const char* sep,
+                            unsigned radix, int flags)
+{
+  if (radix < 2 || radix > 36 || count == 0) {
+    return 0;
+  }
+  size_t total = (count - 1) * nuconv_strlen(sep);
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t mag = src[i] < 0 ? 0 - (uint64_t)src[i] : (uint64_t)src[i];
+    total += nuconv_udigits(mag, radix)
+      + (src[i] < 0 && (flags & NUCONV_FLAG_ABS) == 0);
+  }
+  return total;
+}
+
+size_t nuconv_utoa_bulk_len(const uint64_t* src, size_t count, const char* sep,
+                            unsigned radix, int flags)
+{
+  (void)flags;
+  if (radix < 2 || radix > 36 || count == 0) {
+    return 0;
+  }
+  size_t total = (count - 1) * nuconv_strlen(sep);
+  for (size_t i = 0; i < count; ++i) {
+    total += nuconv_udigits(src[i], radix);
+  }
+  return total;
+}
+
+int nuconv_do_itoa_bulk(const int64_t* src, size_t count, char* buf,
+                        size_t* offsets, size_t* len, const char* sep,
+                        unsigned radix, int flags)
 {
   if (radix < 2 || radix > 36) {
     return -NUCONV_ERROR_RADIX;
   }
-  bool sign = false;
-  if (target < 0) {
-    sign = true;
-    target = -target;
-  }
-  char* low = buf;
-  if ((flags & NUCONV_FLAG_UPPERCASE) != 0)
-    do
-      *buf++ = nuconv_alphabetu[target % radix];
-    while (target /= radix);
-  else
-    do
-      *buf++ = nuconv_alphabetl[target % radix];
-    while (target /= radix);
-  if ((flags & NUCONV_FLAG_ABS) == 0) && sign) {
-    *buf++ = '-';
-  }
-  *buf++ = '\0';
-  nuconv_strrev(low);
+  const size_t seplen = nuconv_strlen(sep);
+  char* ptr = buf;
+  for (size_t i = 0; i < count; ++i) {
+    if (i != 0) {
+      nuconv_memcpy(ptr, sep, seplen);
+      ptr += seplen;
+    }
+    if (offsets != NULL) {
+      offsets[i] = (size_t)(ptr - buf);
+    }
+    const uint64_t mag = src[i] < 0 ? 0 - (uint64_t)src[i] : (uint64_t)src[i];
+    if (src[i] < 0 && (flags & NUCONV_FLAG_ABS) == 0) {
+      *ptr++ = '-';
+    }
+    ptr += nuconv_udigits(mag, radix);
+    nuconv_write_digits(ptr, mag, radix, flags);
+  }
+  *ptr = '\0';
+  if (len != NULL) {
+    *len = (size_t)(ptr - buf);
+  }
   return NUCONV_OK;
 }
 
-int nuconv_do_utoa(uint64_t target, char* buf, unsigned radix, int flags)
+int nuconv_do_utoa_bulk(const uint64_t* src, size_t count, char* buf,
+                        size_t* offsets, size_t* len, const char* sep,
+                        unsigned radix, int flags)
 {
   if (radix < 2 || radix > 36) {
     return -NUCONV_ERROR_RADIX;
   }
-  char* low = buf;
-  if ((flags & NUCONV_FLAG_UPPERCASE) != 0)
-    do
-      *buf++ = nuconv_alphabetu[target % radix];
-    while (target /= radix);
-  else
-    do
-      *buf++ = nuconv_alphabetl[target % radix];
-  *buf++ = '\0';
-  nuconv_strrev(low);
+  const size_t seplen = nuconv_strlen(sep);
+  char* ptr = buf;
+  for (size_t i = 0; i < count; ++i) {
+    if (i != 0) {
+      nuconv_memcpy(ptr, sep, seplen);
+      ptr += seplen;
+    }
+    if (offsets != NULL) {
+      offsets[i] = (size_t)(ptr - buf);
+    }
+    ptr += nuconv_udigits(src[i], radix);
+    nuconv_write_digits(ptr, src[i], radix, flags);
+  }
+  *ptr = '\0';
+  if (len != NULL) {
+    *len = (size_t)(ptr - buf);
+  }
   return NUCONV_OK;
 }
 
 int nuconv_atoi(const char* buf)
 {
-  int64_t res;
-  return nuconv_do_atoi(&res, buf, 10) < 0
+  int32_t res;
+  return nuconv_do_atoi32(&res, buf, NULL, NULL, 10, 0) < 0
     ? 0
     : (int)res;
 }
 
 unsigned int nuconv_atou(const char* buf)
 {
-  uint64_t res;
-  return nuconv_do_atou(&res, buf, 10) < 0
+  uint32_t res;
+  return nuconv_do_atou32(&res, buf, NULL, NULL, 10, 0) < 0
     ? 0
     : (unsigned int)res;
 }
 
 char* nuconv_itoa(int n, char* buf, int radix)
 {
-  nuconv_do_itoa((int64_t) n, buf, (unsigned) radix);
-  return buf + nuconv_strlen(buf);
+  const int len = nuconv_do_itoa32((int32_t) n, buf, (unsigned) radix, 0);
+  return len < 0 ? buf : buf + len;
 }
 
 char* nuconv_utoa(unsigned int n, char* buf, int radix)
 {
-  nuconv_do_utoa((uint64_t) n, buf, (unsigned) radix);
-  return buf + nuconv_strlen(buf);
+  const int len = nuconv_do_utoa32((uint32_t) n, buf, (unsigned) radix, 0);
+  return len < 0 ? buf : buf + len;
 }
 
 NUCONV_MIN(size_t,             nuconv_zmin)
@@ -0,0 +1,76 @@
+#include "nuconv_internal.h"
+
+#ifndef NUCONV_NO_STDLIB
+#include <stdlib.h>
+#endif
+
+struct nuconv_kernels nuconv_kernels;
+/* All scalar: null entries select the portable code. */
+static struct nuconv_kernels nuconv_kernels_scalar;
+
+static int nuconv_tier_max = NUCONV_TIER_SCALAR;
+static int nuconv_tier = NUCONV_TIER_SCALAR;
+
+int nuconv_set_tier(int tier)
+{
+  if (tier < 0 || tier > nuconv_tier_max) {
+    tier = nuconv_tier_max;
+  }
+  struct nuconv_kernels k = nuconv_kernels_scalar;
+#ifdef NUCONV_X86
+  nuconv_x86_kernels(&k, tier);
+#endif
+  nuconv_kernels = k;
+  nuconv_tier = tier;
+  return tier;
+}
+
+int nuconv_get_tier(void)
+{
+  return nuconv_tier;
+}
+
+static int nuconv_parse_tier(const char* name)
+{
+  if (name == NULL) {
+    return NUCONV_TIER_BEST;
+  }
+  if (nuconv_strcmp(name, "scalar") == 0) {
+    return NUCONV_TIER_SCALAR;
+  }
+  if (nuconv_strcmp(name, "sse4.1") == 0) {
+    return NUCONV_TIER_SSE41;
+  }
+  if (nuconv_strcmp(name, "avx2") == 0) {
+    return NUCONV_TIER_AVX2;
+  }
+  /* Anything else must be a tier number and nothing but its digits (the
+     parser would skip signs, blanks and '_'); other values fall back to the
+     best tier rather than to whatever digits they held. */
+  const char* end = name;
+  while (*end >= '0' && *end <= '9') {
+    ++end;
+  }
+  int64_t tier;
+  if (*end == '\0'
+      && nuconv_do_atoin(&tier, name, end, NULL, 10, 0) == NUCONV_OK
+      && tier >= NUCONV_TIER_SCALAR && tier <= NUCONV_TIER_AVX2) {
+    return (int)tier;
+  }
+  return NUCONV_TIER_BEST;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor))
+#endif
+static void nuconv_init_kernels(void)
+{
+#ifdef NUCONV_X86
+  nuconv_tier_max = nuconv_x86_tier();
+#endif
+#ifndef NUCONV_NO_STDLIB
+  nuconv_set_tier(nuconv_parse_tier(getenv("NUCONV_TIER")));
+#else
+  nuconv_set_tier(nuconv_parse_tier(NULL));
+#endif
+}
@@ -0,0 +1,145 @@
+#ifndef NUCONV_INTERNAL_H
+#define NUCONV_INTERNAL_H 1
+
+#include <nuconv.h>
+#include <stdbool.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NUCONV_INTERNAL __attribute__((visibility("hidden")))
+#define NUCONV_NO_ASAN  __attribute__((no_sanitize_address))
+#else
+#define NUCONV_INTERNAL
+#define NUCONV_NO_ASAN
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NUCONV_X86 1
+#endif
+
+#define NUCONV_PAGE_SIZE (4096)
+
+/* True when n bytes can be loaded at ptr: either they lie before end, or,
+   for NUL-terminated input, they do not cross into the next page. */
+static inline bool nuconv_can_load(const char* ptr, const char* end, unsigned n)
+{
+  return end != NULL
+    ? end - ptr >= (ptrdiff_t)n
+    : ((uintptr_t)ptr & (NUCONV_PAGE_SIZE - 1)) <= NUCONV_PAGE_SIZE - n;
+}
+
+NUCONV_NO_ASAN
+static inline uint64_t nuconv_load8(const char* ptr)
+{
+  uint64_t w;
+  __builtin_memcpy(&w, ptr, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  w = __builtin_bswap64(w);
+#endif
+  return w;
+}
+
+/* Number of leading ASCII decimal digits in w (first character in the low
+   byte). */
+static inline unsigned nuconv_swar_digits(uint64_t w)
+{
+  uint64_t x = ((w & 0xF0F0F0F0F0F0F0F0ull)
+    | (((w + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4))
+    ^ 0x3333333333333333ull;
+  x = (((x & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | x)
+    & 0x8080808080808080ull;
+  return x == 0 ? 8 : (unsigned)__builtin_ctzll(x) / 8;
+}
+
+/* Value of the eight ASCII digits in w, first character most significant. */
+static inline uint32_t nuconv_swar_parse8(uint64_t w)
+{
+  w -= 0x3030303030303030ull;
+  w = (w * 10) + (w >> 8);
+  w = (((w & 0x000000FF000000FFull) * 0x000F424000000064ull)
+    + (((w >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+  return (uint32_t)w;
+}
+
+/* Counts the leading decimal digits at ptr (at most the kernel width, which
+   the caller guarantees to be readable). val[0] receives the value of the
+   first min(n, 16) digits and, when n > 16, val[1] the value of the rest. */
+typedef unsigned (*nuconv_parse10_fn)(const char* ptr, uint64_t val[2]);
+
+/* Counts the leading hexadecimal digits in the 16 bytes at ptr and stores
+   their value in *val. */
+typedef unsigned (*nuconv_parse16_fn)(const char* ptr, uint64_t* val);
+
+/* Writes all 16 hexadecimal digits of target, most significant first, using
+   the first 16 characters of alphabet. */
+typedef void (*nuconv_format16_fn)(uint64_t target, char* out,
+                                   const char* alphabet);
+
+/* Needles up to this length are searched by the vector kernel. */
+#define NUCONV_MEMMEM_SHORT (32)
+
+/* Searches needle (2 <= nlen <= NUCONV_MEMMEM_SHORT, nlen <= hlen) in the
+   haystack. */
+typedef void* (*nuconv_memmem_fn)(const uint8_t* h, size_t hlen,
+                                  const uint8_t* n, size_t nlen);
+
+/* Reverses whole vectors from both ends of buf[0, n) and returns how many
+   bytes were handled at each end. */
+typedef size_t (*nuconv_memrev_fn)(char* buf, size_t n);
+
+/* Class membership over whole vectors using the nibble lookup built by
+   nuconv_class_lut: span returns the length of the leading run whose
+   membership equals accept, stopping at the last whole vector; classify
+   fills the bitmap for whole 64-byte groups and returns the bytes done. */
+typedef size_t (*nuconv_span_fn)(const char* buf, size_t n,
+                                 const uint8_t* lut, bool accept);
+typedef size_t (*nuconv_classify_fn)(const char* buf, size_t n,
+                                     const uint8_t* lut, uint64_t* bits);
+
+/* Copies whole vectors of src to dst flipping the case of ASCII letters of
+   the source case; returns the bytes done. */
+typedef size_t (*nuconv_casecpy_fn)(char* dst, const char* src, size_t n,
+                                    bool upper);
+
+struct nuconv_kernels {
+  nuconv_parse10_fn  parse10;
+  unsigned           parse10_width;
+  nuconv_parse16_fn  parse16;
+  nuconv_format16_fn format16;
+  nuconv_memmem_fn   memmem;
+  nuconv_memrev_fn   memrev;
+  nuconv_span_fn     span;
+  nuconv_classify_fn classify;
+  nuconv_casecpy_fn  casecpy;
+};
+
+NUCONV_INTERNAL extern struct nuconv_kernels nuconv_kernels;
+
+#ifdef NUCONV_X86
+NUCONV_INTERNAL int nuconv_x86_tier(void);
+NUCONV_INTERNAL void nuconv_x86_kernels(struct nuconv_kernels* k, int tier);
+NUCONV_INTERNAL unsigned nuconv_parse10_sse41(const char* ptr, uint64_t val[2]);
+NUCONV_INTERNAL unsigned nuconv_parse10_avx2(const char* ptr, uint64_t val[2]);
+NUCONV_INTERNAL unsigned nuconv_parse16_sse41(const char* ptr, uint64_t* val);
+NUCONV_INTERNAL void nuconv_format16_ssse3(uint64_t target, char* out,
+                                           const char* alphabet);
+NUCONV_INTERNAL void* nuconv_memmem_sse2(const uint8_t* h, size_t hlen,
+                                         const uint8_t* n, size_t nlen);
+NUCONV_INTERNAL void* nuconv_memmem_avx2(const uint8_t* h, size_t hlen,
+                                         const uint8_t* n, size_t nlen);
+NUCONV_INTERNAL size_t nuconv_memrev_ssse3(char* buf, size_t n);
+NUCONV_INTERNAL size_t nuconv_memrev_avx2(char* buf, size_t n);
+NUCONV_INTERNAL size_t nuconv_span_ssse3(const char* buf, size_t n,
+                                         const uint8_t* lut, bool accept);
+NUCONV_INTERNAL size_t nuconv_span_avx2(const char* buf, size_t n,
+                                        const uint8_t* lut, bool accept);
+NUCONV_INTERNAL size_t nuconv_classify_ssse3(const char* buf, size_t n,
+                                             const uint8_t* lut, uint64_t* bits);
+NUCONV_INTERNAL size_t nuconv_classify_avx2(const char* buf, size_t n,
+                                            const uint8_t* lut, uint64_t* bits);
+NUCONV_INTERNAL size_t nuconv_casecpy_sse2(char* dst, const char* src,
+                                           size_t n, bool upper);
+NUCONV_INTERNAL size_t nuconv_casecpy_avx2(char* dst, const char* src,
+                                           size_t n, bool upper);
+#endif
+
+#endif /* NUCONV_INTERNAL_H */
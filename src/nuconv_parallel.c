@@ -0,0 +1,295 @@
+#include "nuconv_internal.h"
+
+#ifndef NUCONV_NO_STDLIB
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/* Inputs are cut into about this many chunks per thread so that threads
+   finishing early keep claiming work; chunks never get smaller than
+   NUCONV_PAR_MIN_CHUNK bytes. */
+#define NUCONV_PAR_CHUNKS_PER_THREAD (8)
+#define NUCONV_PAR_MIN_CHUNK         (1u << 16)
+#define NUCONV_PAR_MAX_THREADS       (256)
+
+typedef int (*nuconv_bulk_fn)(void* dst, int* status, size_t* count,
+                              const char* begin, const char* end,
+                              const char** stop, const char* delims,
+                              unsigned radix, int flags);
+
+#ifndef NUCONV_NO_STDLIB
+struct nuconv_par_chunk {
+  const char* begin;
+  const char* end;
+  size_t fields;
+  size_t offset;
+  const char* stop;
+  int ret;
+};
+
+struct nuconv_par_job {
+  struct nuconv_par_chunk* chunks;
+  size_t nchunks;
+  size_t next;
+  int pass;
+  const char* end;
+  const bool* delim;
+  uint64_t splat[4];
+  unsigned ndelim;
+  char* dst;
+  size_t size;
+  int* status;
+  size_t limit;
+  const char* delims;
+  unsigned radix;
+  int flags;
+  nuconv_bulk_fn fn;
+};
+
+/* Field count of a chunk: one per delimiter, plus an unterminated field at
+   the end of the input. */
+static size_t nuconv_par_count(const struct nuconv_par_job* job,
+                               const char* ptr, const char* end)
+{
+  const bool* delim = job->delim;
+  size_t n = 0;
+  if (ptr == end) {
+    return 0;
+  }
+  const bool open = end == job->end && !delim[(unsigned char)end[-1]];
+  /* Eight bytes at a time: a byte equals c exactly when its XOR with c is
+     zero, tested without carries between lanes. */
+  if (job->ndelim <= 4) {
+    for (; end - ptr >= 8; ptr += 8) {
+      const uint64_t w = nuconv_load8(ptr);
+      uint64_t hits = 0;
+      for (unsigned i = 0; i < job->ndelim; ++i) {
+        const uint64_t x = w ^ job->splat[i];
+        hits |= ~(((x & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | x);
+      }
+      n += (size_t)__builtin_popcountll(hits & 0x8080808080808080ull);
+    }
+  }
+  for (; ptr != end; ++ptr) {
+    n += delim[(unsigned char)*ptr];
+  }
+  return n + open;
+}
+
+static void nuconv_par_run(struct nuconv_par_job* job,
+                           struct nuconv_par_chunk* c)
+{
+  if (job->pass == 0) {
+    c->fields = nuconv_par_count(job, c->begin, c->end);
+    return;
+  }
+  size_t count = c->fields;
+  if (count == 0 || c->offset >= job->limit) {
+    c->fields = 0;
+    return;
+  }
+  if (count > job->limit - c->offset) {
+    count = job->limit - c->offset;
+  }
+  c->ret = job->fn(job->dst + c->offset * job->size,
+                   job->status != NULL ? job->status + c->offset : NULL,
+                   &count, c->begin, c->end, &c->stop, job->delims,
+                   job->radix, job->flags);
+  c->fields = count;
+}
+
+/* Chunks are claimed one at a time from a shared counter, so a thread that
+   drew cheap chunks takes over the rest of the work of slower ones. */
+static void* nuconv_par_worker(void* arg)
+{
+  struct nuconv_par_job* job = (struct nuconv_par_job*)arg;
+  for (;;) {
+    const size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+    if (i >= job->nchunks) {
+      return NULL;
+    }
+    nuconv_par_run(job, &job->chunks[i]);
+  }
+}
+
+static void nuconv_par_pass(struct nuconv_par_job* job, unsigned threads)
+{
+  pthread_t tids[NUCONV_PAR_MAX_THREADS];
+  unsigned started = 0;
+  job->next = 0;
+  for (; started + 1 < threads; ++started) {
+    if (pthread_create(&tids[started], NULL, nuconv_par_worker, job) != 0) {
+      break;
+    }
+  }
+  nuconv_par_worker(job);
+  while (started > 0) {
+    pthread_join(tids[--started], NULL);
+  }
+}
+
+static unsigned nuconv_par_threads(unsigned threads)
+{
+  if (threads == 0) {
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = n > 0 ? (unsigned)n : 1;
+  }
+  return threads < NUCONV_PAR_MAX_THREADS ? threads : NUCONV_PAR_MAX_THREADS;
+}
+
+static bool nuconv_par_is_digit(unsigned char c, unsigned radix)
+{
+  unsigned v = 36;
+  if (c >= '0' && c <= '9') {
+    v = c - '0';
+  } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+    v = (c | 0x20) - 'a' + 10;
+  }
+  return v < radix;
+}
+#endif
+
+static int nuconv_do_bulk_parallel(void* dst, size_t size, int* status,
+                                   size_t* count, const char* begin,
+                                   const char* end, const char** stop,
+                                   const char* delims, unsigned radix,
+                                   int flags, unsigned threads,
+                                   nuconv_bulk_fn fn)
+{
+  if (end == NULL) {
+    end = begin + nuconv_strlen(begin);
+  }
+#ifndef NUCONV_NO_STDLIB
+  const size_t len = (size_t)(end - begin);
+  threads = nuconv_par_threads(threads);
+  size_t nchunks = (size_t)threads * NUCONV_PAR_CHUNKS_PER_THREAD;
+  if (nchunks > len / NUCONV_PAR_MIN_CHUNK) {
+    nchunks = len / NUCONV_PAR_MIN_CHUNK;
+  }
+  if (radix < 2 || radix > 36 || threads < 2 || nchunks < 2) {
+    return fn(dst, status, count, begin, end, stop, delims, radix, flags);
+  }
+  struct nuconv_par_chunk* chunks =
+    (struct nuconv_par_chunk*)malloc(nchunks * sizeof(*chunks));
+  if (chunks == NULL) {
+    return fn(dst, status, count, begin, end, stop, delims, radix, flags);
+  }
+
+  /* Delimiters that are digits of radix belong to the field, as in the
+     sequential parsers. */
+  bool delim[256] = {false};
+  for (const char* d = delims; *d != '\0'; ++d) {
+    const unsigned char c = (unsigned char)*d;
+    delim[c] = !nuconv_par_is_digit(c, radix);
+  }
+
+  /* Split just after the first delimiter at or past each even cut. */
+  const char* ptr = begin;
+  for (size_t i = 0; i < nchunks; ++i) {
+    const char* cut = i + 1 == nchunks ? end : begin + len / nchunks * (i + 1);
+    if (cut < ptr) {
+      cut = ptr;
+    }
+    while (cut != end && !delim[(unsigned char)cut[-1]]) {
+      ++cut;
+    }
+    chunks[i].begin = ptr;
+    chunks[i].end = cut;
+    chunks[i].ret = NUCONV_OK;
+    chunks[i].stop = ptr;
+    ptr = cut;
+  }
+
+  struct nuconv_par_job job;
+  job.chunks = chunks;
+  job.nchunks = nchunks;
+  job.end = end;
+  job.delim = delim;
+  job.ndelim = 0;
+  for (unsigned c = 0; c < 256; ++c) {
+    if (delim[c] && job.ndelim++ < 4) {
+      job.splat[job.ndelim - 1] = 0x0101010101010101ull * c;
+    }
+  }
+  job.dst = (char*)dst;
+  job.size = size;
+  job.status = status;
+  job.limit = *count;
+  job.delims = delims;
+  job.radix = radix;
+  job.flags = flags;
+  job.fn = fn;
+
+  job.pass = 0;
+  nuconv_par_pass(&job, threads);
+  size_t total = 0;
+  for (size_t i = 0; i < nchunks; ++i) {
+    chunks[i].offset = total;
+    total += chunks[i].fields;
+  }
+
+  job.pass = 1;
+  nuconv_par_pass(&job, threads);
+  int ret = NUCONV_OK;
+  const char* last = begin;
+  total = 0;
+  for (size_t i = 0; i < nchunks; ++i) {
+    if (chunks[i].fields != 0) {
+      last = chunks[i].stop;
+      total += chunks[i].fields;
+      if (ret == NUCONV_OK) {
+        ret = chunks[i].ret;
+      }
+    }
+  }
+  free(chunks);
+  *count = total;
+  if (stop != NULL) {
+    *stop = last;
+  }
+  return ret;
+#else
+  (void)size;
+  (void)threads;
+  return fn(dst, status, count, begin, end, stop, delims, radix, flags);
+#endif
+}
+
+static int nuconv_par_atoi(void* dst, int* status, size_t* count,
+                           const char* begin, const char* end,
+                           const char** stop, const char* delims,
+                           unsigned radix, int flags)
+{
+  return nuconv_do_atoi_bulk((int64_t*)dst, status, count, begin, end, stop,
+                             delims, radix, flags);
+}
+
+static int nuconv_par_atou(void* dst, int* status, size_t* count,
+                           const char* begin, const char* end,
+                           const char** stop, const char* delims,
+                           unsigned radix, int flags)
+{
+  return nuconv_do_atou_bulk((uint64_t*)dst, status, count, begin, end, stop,
+                             delims, radix, flags);
+}
+
+int nuconv_do_atoi_bulk_parallel(int64_t* dst, int* status, size_t* count,
+                                 const char* begin, const char* end,
+                                 const char** stop, const char* delims,
+                                 unsigned radix, int flags, unsigned threads)
+{
+  return nuconv_do_bulk_parallel(dst, sizeof(*dst), status, count, begin, end,
+                                 stop, delims, radix, flags, threads,
+                                 nuconv_par_atoi);
+}
+
+int nuconv_do_atou_bulk_parallel(uint64_t* dst, int* status, size_t* count,
+                                 const char* begin, const char* end,
+                                 const char** stop, const char* delims,
+                                 unsigned radix, int flags, unsigned threads)
+{
+  return nuconv_do_bulk_parallel(dst, sizeof(*dst), status, count, begin, end,
+                                 stop, delims, radix, flags, threads,
+                                 nuconv_par_atou);
+}
@@ -0,0 +1,356 @@
+#include "nuconv_internal.h"
+
+#ifdef NUCONV_X86
+
+#include <immintrin.h>
+
+__attribute__((target("sse4.1"))) NUCONV_NO_ASAN
+static inline uint64_t nuconv_reduce16_sse41(__m128i x)
+{
+  x = _mm_maddubs_epi16(x, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1,
+                                         10, 1, 10, 1, 10, 1, 10, 1));
+  x = _mm_madd_epi16(x, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  x = _mm_packus_epi32(x, x);
+  x = _mm_madd_epi16(x, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  return (uint64_t)(uint32_t)_mm_cvtsi128_si32(x) * 100000000u
+    + (uint32_t)_mm_extract_epi32(x, 1);
+}
+
+__attribute__((target("sse4.1"))) NUCONV_NO_ASAN
+unsigned nuconv_parse10_sse41(const char* ptr, uint64_t val[2])
+{
+  const __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)ptr),
+                                 _mm_set1_epi8('0'));
+  const __m128i d = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(9)), v);
+  const unsigned n = (unsigned)__builtin_ctz(~(unsigned)_mm_movemask_epi8(d));
+  if (n == 0) {
+    return 0;
+  }
+  /* Right-align the digits; negative indices make pshufb emit zeroes. */
+  const __m128i idx = _mm_add_epi8(
+    _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+    _mm_set1_epi8((char)(n - 16)));
+  val[0] = nuconv_reduce16_sse41(_mm_shuffle_epi8(v, idx));
+  return n;
+}
+
+__attribute__((target("avx2"))) NUCONV_NO_ASAN
+unsigned nuconv_parse10_avx2(const char* ptr, uint64_t val[2])
+{
+  const __m256i v = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)ptr),
+                                    _mm256_set1_epi8('0'));
+  const __m256i d = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(9)), v);
+  const uint32_t mask = (uint32_t)_mm256_movemask_epi8(d);
+  const unsigned n = mask == UINT32_MAX ? 32 : (unsigned)__builtin_ctz(~mask);
+  if (n == 0) {
+    return 0;
+  }
+  const unsigned lo = n > 16 ? 16 : n;
+  const unsigned hi = n > 16 ? n - 16 : 0;
+  const __m256i iota = _mm256_setr_epi8(
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m256i shift = _mm256_inserti128_si256(
+    _mm256_castsi128_si256(_mm_set1_epi8((char)(lo - 16))),
+    _mm_set1_epi8((char)(hi - 16)), 1);
+  __m256i x = _mm256_shuffle_epi8(v, _mm256_add_epi8(iota, shift));
+  x = _mm256_maddubs_epi16(x, _mm256_setr_epi8(
+    10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+    10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+  x = _mm256_madd_epi16(x, _mm256_setr_epi16(
+    100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1));
+  x = _mm256_packus_epi32(x, x);
+  x = _mm256_madd_epi16(x, _mm256_setr_epi16(
+    10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  val[0] = (uint64_t)(uint32_t)_mm256_extract_epi32(x, 0) * 100000000u
+    + (uint32_t)_mm256_extract_epi32(x, 1);
+  val[1] = (uint64_t)(uint32_t)_mm256_extract_epi32(x, 4) * 100000000u
+    + (uint32_t)_mm256_extract_epi32(x, 5);
+  return n;
+}
+
+__attribute__((target("sse4.1"))) NUCONV_NO_ASAN
+unsigned nuconv_parse16_sse41(const char* ptr, uint64_t* val)
+{
+  const __m128i c = _mm_loadu_si128((const __m128i*)ptr);
+  const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  const __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+                                 _mm_set1_epi8('a'));
+  const __m128i isd = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+  const __m128i isl = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+  const __m128i v = _mm_or_si128(
+    _mm_and_si128(isd, d),
+    _mm_and_si128(isl, _mm_add_epi8(l, _mm_set1_epi8(10))));
+  const unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(isd, isl));
+  const unsigned n = (unsigned)__builtin_ctz(~mask);
+  if (n == 0) {
+    return 0;
+  }
+  const __m128i idx = _mm_add_epi8(
+    _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+    _mm_set1_epi8((char)(n - 16)));
+  __m128i x = _mm_shuffle_epi8(v, idx);
+  x = _mm_maddubs_epi16(x, _mm_setr_epi8(16, 1, 16, 1, 16, 1, 16, 1,
+                                         16, 1, 16, 1, 16, 1, 16, 1));
+  x = _mm_packus_epi16(x, x);
+  *val = __builtin_bswap64((uint64_t)_mm_cvtsi128_si64(x));
+  return n;
+}
+
+__attribute__((target("ssse3")))
+void nuconv_format16_ssse3(uint64_t target, char* out, const char* alphabet)
+{
+  const __m128i x = _mm_cvtsi64_si128((long long)__builtin_bswap64(target));
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  const __m128i nibbles = _mm_unpacklo_epi8(
+    _mm_and_si128(_mm_srli_epi16(x, 4), mask),
+    _mm_and_si128(x, mask));
+  _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(
+    _mm_loadu_si128((const __m128i*)alphabet), nibbles));
+}
+
+/* First/last byte candidate filter; candidates are verified with memcmp. */
+static void* nuconv_memmem_tail(const uint8_t* h, size_t hlen,
+                                const uint8_t* n, size_t nlen)
+{
+  for (size_t i = 0; i + nlen <= hlen; ++i) {
+    if (h[i] == n[0] && nuconv_memcmp((const char*)h + i, (const char*)n, nlen) == 0) {
+      return (void*)(h + i);
+    }
+  }
+  return NULL;
+}
+
+void* nuconv_memmem_sse2(const uint8_t* h, size_t hlen,
+                         const uint8_t* n, size_t nlen)
+{
+  const __m128i first = _mm_set1_epi8((char)n[0]);
+  const __m128i last = _mm_set1_epi8((char)n[nlen - 1]);
+  size_t i = 0;
+  for (; i + nlen + 15 <= hlen; i += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(h + i));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(h + i + nlen - 1));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+      _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+    while (mask != 0) {
+      const unsigned bit = (unsigned)__builtin_ctz(mask);
+      if (nuconv_memcmp((const char*)h + i + bit + 1, (const char*)n + 1, nlen - 2) == 0) {
+        return (void*)(h + i + bit);
+      }
+      mask &= mask - 1;
+    }
+  }
+  return nuconv_memmem_tail(h + i, hlen - i, n, nlen);
+}
+
+__attribute__((target("avx2")))
+void* nuconv_memmem_avx2(const uint8_t* h, size_t hlen,
+                         const uint8_t* n, size_t nlen)
+{
+  const __m256i first = _mm256_set1_epi8((char)n[0]);
+  const __m256i last = _mm256_set1_epi8((char)n[nlen - 1]);
+  size_t i = 0;
+  for (; i + nlen + 31 <= hlen; i += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i*)(h + i));
+    const __m256i b = _mm256_loadu_si256((const __m256i*)(h + i + nlen - 1));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+      _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+    while (mask != 0) {
+      const unsigned bit = (unsigned)__builtin_ctz(mask);
+      if (nuconv_memcmp((const char*)h + i + bit + 1, (const char*)n + 1, nlen - 2) == 0) {
+        return (void*)(h + i + bit);
+      }
+      mask &= mask - 1;
+    }
+  }
+  return i < hlen ? nuconv_memmem_sse2(h + i, hlen - i, n, nlen) : NULL;
+}
+
+__attribute__((target("ssse3")))
+size_t nuconv_memrev_ssse3(char* buf, size_t n)
+{
+  const __m128i rev = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                    7, 6, 5, 4, 3, 2, 1, 0);
+  size_t i = 0;
+  for (; n - 2 * i >= 32; i += 16) {
+    const __m128i x = _mm_loadu_si128((const __m128i*)(buf + i));
+    const __m128i y = _mm_loadu_si128((const __m128i*)(buf + n - i - 16));
+    _mm_storeu_si128((__m128i*)(buf + i), _mm_shuffle_epi8(y, rev));
+    _mm_storeu_si128((__m128i*)(buf + n - i - 16), _mm_shuffle_epi8(x, rev));
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t nuconv_memrev_avx2(char* buf, size_t n)
+{
+  const __m256i rev = _mm256_setr_epi8(
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  size_t i = 0;
+  for (; n - 2 * i >= 64; i += 32) {
+    const __m256i x = _mm256_loadu_si256((const __m256i*)(buf + i));
+    const __m256i y = _mm256_loadu_si256((const __m256i*)(buf + n - i - 32));
+    _mm256_storeu_si256((__m256i*)(buf + i),
+      _mm256_permute4x64_epi64(_mm256_shuffle_epi8(y, rev), 0x4E));
+    _mm256_storeu_si256((__m256i*)(buf + n - i - 32),
+      _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, rev), 0x4E));
+  }
+  return i + nuconv_memrev_ssse3(buf + i, n - 2 * i);
+}
+
+__attribute__((target("ssse3")))
+static inline unsigned nuconv_class16_ssse3(const char* ptr, __m128i lo, __m128i hi)
+{
+  const __m128i c = _mm_loadu_si128((const __m128i*)ptr);
+  const __m128i nib = _mm_set1_epi8(0x0F);
+  const __m128i m = _mm_and_si128(
+    _mm_shuffle_epi8(lo, _mm_and_si128(c, nib)),
+    _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(c, 4), nib)));
+  return ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128()))
+    & 0xFFFF;
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t nuconv_class32_avx2(const char* ptr, __m256i lo, __m256i hi)
+{
+  const __m256i c = _mm256_loadu_si256((const __m256i*)ptr);
+  const __m256i nib = _mm256_set1_epi8(0x0F);
+  const __m256i m = _mm256_and_si256(
+    _mm256_shuffle_epi8(lo, _mm256_and_si256(c, nib)),
+    _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(c, 4), nib)));
+  return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(m, _mm256_setzero_si256()));
+}
+
+__attribute__((target("ssse3")))
+size_t nuconv_span_ssse3(const char* buf, size_t n, const uint8_t* lut,
+                         bool accept)
+{
+  const __m128i lo = _mm_loadu_si128((const __m128i*)lut);
+  const __m128i hi = _mm_loadu_si128((const __m128i*)(lut + 16));
+  const unsigned flip = accept ? 0xFFFF : 0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const unsigned miss = nuconv_class16_ssse3(buf + i, lo, hi) ^ flip;
+    if (miss != 0) {
+      return i + (unsigned)__builtin_ctz(miss);
+    }
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t nuconv_span_avx2(const char* buf, size_t n, const uint8_t* lut,
+                        bool accept)
+{
+  const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lut));
+  const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(lut + 16)));
+  const uint32_t flip = accept ? UINT32_MAX : 0;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const uint32_t miss = nuconv_class32_avx2(buf + i, lo, hi) ^ flip;
+    if (miss != 0) {
+      return i + (unsigned)__builtin_ctz(miss);
+    }
+  }
+  return i;
+}
+
+__attribute__((target("ssse3")))
+size_t nuconv_classify_ssse3(const char* buf, size_t n, const uint8_t* lut,
+                             uint64_t* bits)
+{
+  const __m128i lo = _mm_loadu_si128((const __m128i*)lut);
+  const __m128i hi = _mm_loadu_si128((const __m128i*)(lut + 16));
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    bits[i / 64] = (uint64_t)nuconv_class16_ssse3(buf + i, lo, hi)
+      | (uint64_t)nuconv_class16_ssse3(buf + i + 16, lo, hi) << 16
+      | (uint64_t)nuconv_class16_ssse3(buf + i + 32, lo, hi) << 32
+      | (uint64_t)nuconv_class16_ssse3(buf + i + 48, lo, hi) << 48;
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t nuconv_classify_avx2(const char* buf, size_t n, const uint8_t* lut,
+                            uint64_t* bits)
+{
+  const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lut));
+  const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(lut + 16)));
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    bits[i / 64] = (uint64_t)nuconv_class32_avx2(buf + i, lo, hi)
+      | (uint64_t)nuconv_class32_avx2(buf + i + 32, lo, hi) << 32;
+  }
+  return i;
+}
+
+size_t nuconv_casecpy_sse2(char* dst, const char* src, size_t n, bool upper)
+{
+  const __m128i lo = _mm_set1_epi8(upper ? 'a' : 'A');
+  const __m128i span = _mm_set1_epi8('Z' - 'A');
+  const __m128i bit = _mm_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i c = _mm_loadu_si128((const __m128i*)(src + i));
+    const __m128i t = _mm_sub_epi8(c, lo);
+    const __m128i in = _mm_cmpeq_epi8(_mm_min_epu8(t, span), t);
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(c, _mm_and_si128(in, bit)));
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t nuconv_casecpy_avx2(char* dst, const char* src, size_t n, bool upper)
+{
+  const __m256i lo = _mm256_set1_epi8(upper ? 'a' : 'A');
+  const __m256i span = _mm256_set1_epi8('Z' - 'A');
+  const __m256i bit = _mm256_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i c = _mm256_loadu_si256((const __m256i*)(src + i));
+    const __m256i t = _mm256_sub_epi8(c, lo);
+    const __m256i in = _mm256_cmpeq_epi8(_mm256_min_epu8(t, span), t);
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(c, _mm256_and_si256(in, bit)));
+  }
+  return i;
+}
+
+int nuconv_x86_tier(void)
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return NUCONV_TIER_AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3")) {
+    return NUCONV_TIER_SSE41;
+  }
+  return NUCONV_TIER_SCALAR;
+}
+
+void nuconv_x86_kernels(struct nuconv_kernels* k, int tier)
+{
+  if (tier >= NUCONV_TIER_SSE41) {
+    k->parse10 = nuconv_parse10_sse41;
+    k->parse10_width = 16;
+    k->parse16 = nuconv_parse16_sse41;
+    k->format16 = nuconv_format16_ssse3;
+    k->memmem = nuconv_memmem_sse2;
+    k->memrev = nuconv_memrev_ssse3;
+    k->span = nuconv_span_ssse3;
+    k->classify = nuconv_classify_ssse3;
+    k->casecpy = nuconv_casecpy_sse2;
+  }
+  if (tier >= NUCONV_TIER_AVX2) {
+    k->parse10 = nuconv_parse10_avx2;
+    k->parse10_width = 32;
+    k->memmem = nuconv_memmem_avx2;
+    k->memrev = nuconv_memrev_avx2;
+    k->span = nuconv_span_avx2;
+    k->classify = nuconv_classify_avx2;
+    k->casecpy = nuconv_casecpy_avx2;
+  }
+}
+
+#endif /* NUCONV_X86 */
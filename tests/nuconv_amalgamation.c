@@ -0,0 +1,27 @@
+/* Compiles the single-header build as the implementation translation unit,
+   once as C and once as C++ (nuconv_amalgamation.cpp). */
+#define NUCONV_IMPLEMENTATION
+#include <nuconv.h>
+
+#include <stdio.h>
+#include <string.h>
+
+int main(void)
+{
+  int fails = 0;
+  int64_t v = 0;
+  if (nuconv_do_atoi64(&v, "-123", NULL, NULL, 10, 0) != NUCONV_OK
+      || v != -123) {
+    ++fails;
+  }
+  char buf[32];
+  nuconv_do_utoa(255, buf, 16, NUCONV_FLAG_UPPERCASE);
+  if (strcmp(buf, "FF") != 0) {
+    ++fails;
+  }
+  if (nuconv_imin(3, -4) != -4 || nuconv_zmax(2, 9) != 9) {
+    ++fails;
+  }
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1 @@
+#include "nuconv_amalgamation.c"
@@ -0,0 +1,87 @@
+#ifndef NUCONV_TEST_H
+#define NUCONV_TEST_H 1
+
+#include <nuconv.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int nuconv_test_fails;
+
+/* Report a failed condition with the message formatted by the remaining
+   arguments, and keep going. */
+#define NUCONV_CHECK(cond, ...)                                               \
+  do {                                                                        \
+    if (!(cond)) {                                                            \
+      if (++nuconv_test_fails <= 20) {                                        \
+        fprintf(stderr, "%s:%d: %s: ", __FILE__, __LINE__, #cond);            \
+        fprintf(stderr, __VA_ARGS__);                                         \
+        fputc('\n', stderr);                                                  \
+      }                                                                       \
+    }                                                                         \
+  } while (0)
+
+/* Deterministic xorshift64* so failures reproduce. */
+static uint64_t nuconv_test_state = 0x9E3779B97F4A7C15ull;
+
+static inline uint64_t nuconv_test_rand(void)
+{
+  nuconv_test_state ^= nuconv_test_state >> 12;
+  nuconv_test_state ^= nuconv_test_state << 25;
+  nuconv_test_state ^= nuconv_test_state >> 27;
+  return nuconv_test_state * 0x2545F4914F6CDD1Dull;
+}
+
+/* Fills tiers with every kernel tier the CPU supports, scalar first, and
+   returns how many there are. */
+static inline int nuconv_test_tiers(int tiers[NUCONV_TIER_AVX2 + 1])
+{
+  int n = 0;
+  for (int tier = NUCONV_TIER_SCALAR; tier <= NUCONV_TIER_AVX2; ++tier) {
+    if (nuconv_set_tier(tier) == tier) {
+      tiers[n++] = tier;
+    }
+  }
+  return n;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Returns the start of an inaccessible page preceded by at least n readable
+   bytes, so that buffers placed right before it fault on any overread; NULL
+   when the mapping fails. */
+static inline char* nuconv_test_guard_page(size_t n)
+{
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t len = (n + page - 1) / page * page;
+  char* p = (char*)mmap(NULL, len + page, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+  if (mprotect(p + len, page, PROT_NONE) != 0) {
+    munmap(p, len + page);
+    return NULL;
+  }
+  return p + len;
+}
+#else
+static inline char* nuconv_test_guard_page(size_t n)
+{
+  (void)n;
+  return NULL;
+}
+#endif
+
+static inline int nuconv_test_result(const char* name)
+{
+  printf("%s: %d failure%s\n", name, nuconv_test_fails,
+         nuconv_test_fails == 1 ? "" : "s");
+  return nuconv_test_fails != 0;
+}
+
+#endif /* NUCONV_TEST_H */
@@ -0,0 +1,291 @@
+#include "nuconv_test.h"
+
+/* Checks the bulk parsers against nuconv_do_atoin/nuconv_do_atoun applied
+   to each field found by splitting the input by hand, and the bulk
+   formatters against nuconv_do_itoa/nuconv_do_utoa joined by hand. */
+
+#define MAX_FIELDS (64)
+
+static unsigned digit_value(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return (unsigned)(c - '0');
+  }
+  if (c >= 'a' && c <= 'z') {
+    return (unsigned)(c - 'a' + 10);
+  }
+  if (c >= 'A' && c <= 'Z') {
+    return (unsigned)(c - 'A' + 10);
+  }
+  return 99;
+}
+
+/* Characters of delims that are digits of radix do not delimit. */
+static bool is_delim(char c, const char* delims, unsigned radix)
+{
+  return c != '\0' && strchr(delims, c) != NULL && digit_value(c) >= radix;
+}
+
+struct bulk_result {
+  uint64_t dst[MAX_FIELDS];
+  int status[MAX_FIELDS];
+  size_t count;
+  const char* stop;
+  int r;
+};
+
+static void ref_bulk(struct bulk_result* out, const char* begin,
+                     const char* end, const char* delims, unsigned radix,
+                     bool sig, size_t cap)
+{
+  const char* ptr = begin;
+  out->r = NUCONV_OK;
+  out->count = 0;
+  while (out->count < cap && ptr != end) {
+    const char* field = ptr;
+    while (ptr != end && !is_delim(*ptr, delims, radix)) {
+      ++ptr;
+    }
+    const size_t i = out->count++;
+    int r;
+    if (sig) {
+      int64_t v;
+      r = nuconv_do_atoin(&v, field, ptr, NULL, radix, 0);
+      out->dst[i] = (uint64_t)v;
+    } else {
+      r = nuconv_do_atoun(&out->dst[i], field, ptr, NULL, radix, 0);
+    }
+    out->status[i] = r;
+    if (out->r == NUCONV_OK) {
+      out->r = r;
+    }
+    if (ptr != end) {
+      ++ptr;
+    }
+  }
+  out->stop = ptr;
+}
+
+static void run_bulk(struct bulk_result* out, const char* begin,
+                     const char* end, const char* delims, unsigned radix,
+                     bool sig, size_t cap)
+{
+  memset(out->dst, 0x5A, sizeof(out->dst));
+  out->count = cap;
+  out->r = sig
+    ? nuconv_do_atoi_bulk((int64_t*)out->dst, out->status, &out->count, begin,
+                          end, &out->stop, delims, radix, 0)
+    : nuconv_do_atou_bulk(out->dst, out->status, &out->count, begin, end,
+                          &out->stop, delims, radix, 0);
+}
+
+static void check(const char* text, size_t len, const char* delims,
+                  unsigned radix, size_t cap)
+{
+  for (int sig = 0; sig < 2; ++sig) {
+    struct bulk_result want;
+    struct bulk_result got;
+    ref_bulk(&want, text, text + len, delims, radix, sig, cap);
+    for (int nul = 0; nul < 2; ++nul) {
+      run_bulk(&got, text, nul ? NULL : text + len, delims, radix, sig, cap);
+      NUCONV_CHECK(got.r == want.r && got.count == want.count
+                   && got.stop == want.stop, "%s_bulk(\"%s\", \"%s\", radix "
+                   "%u, count %zu%s): %d/%zu/+%td, want %d/%zu/+%td",
+                   sig ? "atoi" : "atou", text, delims, radix, cap,
+                   nul ? ", NULL end" : "", got.r, got.count,
+                   got.stop - text, want.r, want.count, want.stop - text);
+      for (size_t i = 0; i < want.count && i < got.count; ++i) {
+        NUCONV_CHECK(got.status[i] == want.status[i]
+                     && got.dst[i] == want.dst[i], "%s_bulk(\"%s\", \"%s\", "
+                     "radix %u) field %zu: %" PRIx64 "/%d, want %" PRIx64
+                     "/%d", sig ? "atoi" : "atou", text, delims, radix, i,
+                     got.dst[i], got.status[i], want.dst[i], want.status[i]);
+      }
+    }
+  }
+}
+
+/* A field that is empty, a number (possibly signed, long enough to
+   overflow, or with skip characters), or a number with a bad character. */
+static size_t random_field(char* buf, unsigned radix)
+{
+  static const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  size_t n = 0;
+  const unsigned kind = (unsigned)(nuconv_test_rand() % 8);
+  if (kind == 0) {
+    return 0;
+  }
+  if (kind == 1) {
+    buf[n++] = " _+"[nuconv_test_rand() % 3];
+    return n;
+  }
+  if (nuconv_test_rand() % 3 == 0) {
+    buf[n++] = '-';
+  }
+  const unsigned digits = 1 + (unsigned)(nuconv_test_rand() % 24);
+  for (unsigned i = 0; i < digits; ++i) {
+    buf[n++] = alphabet[nuconv_test_rand() % radix];
+    if (nuconv_test_rand() % 16 == 0) {
+      buf[n++] = " _"[nuconv_test_rand() % 2];
+    }
+  }
+  if (kind == 2) {
+    buf[n++] = "xyz!.\x80"[nuconv_test_rand() % 6];
+  }
+  return n;
+}
+
+static void test_random(void)
+{
+  static const char* const delims[] = {
+    ",", ",;", "\t\n", " ", "-", "a,", "7,", "9\n", "z;", "+_",
+  };
+  static const unsigned radixes[] = {10, 16, 8, 2, 36};
+  char text[MAX_FIELDS * 40];
+  for (int iter = 0; iter < 100000; ++iter) {
+    const char* const d = delims[nuconv_test_rand() % 10];
+    const unsigned radix = radixes[nuconv_test_rand() % 5];
+    const size_t fields = (size_t)(nuconv_test_rand() % 12);
+    size_t len = 0;
+    for (size_t f = 0; f < fields; ++f) {
+      len += random_field(text + len, radix);
+      if (f + 1 < fields || nuconv_test_rand() % 4 == 0) {
+        text[len++] = d[nuconv_test_rand() % strlen(d)];
+      }
+    }
+    text[len] = '\0';
+    const size_t cap = nuconv_test_rand() % 4 == 0
+      ? (size_t)(nuconv_test_rand() % (fields + 1))
+      : MAX_FIELDS;
+    check(text, len, d, radix, cap);
+  }
+}
+
+static void test_cases(void)
+{
+  static const struct {
+    const char* text;
+    const char* delims;
+    unsigned radix;
+    size_t cap;
+    size_t count;
+    size_t stop;
+  } cases[] = {
+    {"", ",", 10, 8, 0, 0},
+    {",", ",", 10, 8, 1, 1},
+    {"1,2,", ",", 10, 8, 2, 4},
+    {"1,,3", ",", 10, 8, 3, 4},
+    {"1,2,3", ",", 10, 2, 2, 4},
+    {"1,2,3", ",", 10, 0, 0, 0},
+    {"1a2,3", "a,", 16, 8, 2, 5},
+    {"1a2,3", "a,", 10, 8, 3, 5},
+    {"12 34", " ", 10, 8, 2, 5},
+    {"1-2", "-", 10, 8, 2, 3},
+    {"9223372036854775808,1", ",", 10, 8, 2, 21},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(*cases); ++i) {
+    int64_t dst[8];
+    int status[8];
+    size_t count = cases[i].cap;
+    const char* stop;
+    nuconv_do_atoi_bulk(dst, status, &count, cases[i].text, NULL, &stop,
+                        cases[i].delims, cases[i].radix, 0);
+    NUCONV_CHECK(count == cases[i].count
+                 && (size_t)(stop - cases[i].text) == cases[i].stop,
+                 "\"%s\" \"%s\" radix %u: count %zu, stop +%td",
+                 cases[i].text, cases[i].delims, cases[i].radix, count,
+                 stop - cases[i].text);
+    check(cases[i].text, strlen(cases[i].text), cases[i].delims,
+          cases[i].radix, cases[i].cap);
+  }
+  int64_t dst[1];
+  size_t count = 1;
+  const char* stop;
+  NUCONV_CHECK(nuconv_do_atoi_bulk(dst, NULL, &count, "1", NULL, &stop, ",",
+                                   37, 0) == -NUCONV_ERROR_RADIX
+               && count == 0, "radix 37");
+}
+
+/* Values of every magnitude, with the extremes of both types. */
+static uint64_t random_value(void)
+{
+  static const uint64_t edges[] = {0, 1, INT64_MAX, (uint64_t)INT64_MIN,
+                                   UINT64_MAX};
+  return nuconv_test_rand() % 8 == 0
+    ? edges[nuconv_test_rand() % 5]
+    : nuconv_test_rand() >> (nuconv_test_rand() % 64);
+}
+
+static void test_format(void)
+{
+  static const char* const seps[] = {",", "", ", ", "\t", "--"};
+  uint64_t src[MAX_FIELDS];
+  char want[MAX_FIELDS * 72];
+  char got[MAX_FIELDS * 72];
+  size_t offsets[MAX_FIELDS + 1];
+  size_t want_offsets[MAX_FIELDS];
+  for (int iter = 0; iter < 50000; ++iter) {
+    const size_t count = (size_t)(nuconv_test_rand() % MAX_FIELDS);
+    const char* const sep = seps[nuconv_test_rand() % 5];
+    const unsigned radix = nuconv_test_rand() % 2
+      ? 10
+      : 2 + (unsigned)(nuconv_test_rand() % 35);
+    const int flags = (nuconv_test_rand() % 2 ? NUCONV_FLAG_UPPERCASE : 0)
+      | (nuconv_test_rand() % 4 == 0 ? NUCONV_FLAG_ABS : 0);
+    const bool sig = nuconv_test_rand() % 2;
+    for (size_t i = 0; i < count; ++i) {
+      src[i] = random_value();
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (i != 0) {
+        len += (size_t)sprintf(want + len, "%s", sep);
+      }
+      want_offsets[i] = len;
+      len += (size_t)(sig
+        ? nuconv_do_itoa((int64_t)src[i], want + len, radix, flags)
+        : nuconv_do_utoa(src[i], want + len, radix, flags));
+    }
+    want[len] = '\0';
+    const size_t need = sig
+      ? nuconv_itoa_bulk_len((const int64_t*)src, count, sep, radix, flags)
+      : nuconv_utoa_bulk_len(src, count, sep, radix, flags);
+    NUCONV_CHECK(need == len, "%s_bulk_len count %zu radix %u flags %d: "
+                 "%zu, want %zu", sig ? "itoa" : "utoa", count, radix, flags,
+                 need, len);
+    memset(got, '#', sizeof(got));
+    offsets[count] = 12345;
+    size_t got_len = 0;
+    const int r = sig
+      ? nuconv_do_itoa_bulk((const int64_t*)src, count, got, offsets,
+                            &got_len, sep, radix, flags)
+      : nuconv_do_utoa_bulk(src, count, got, offsets, &got_len, sep, radix,
+                            flags);
+    NUCONV_CHECK(r == NUCONV_OK && got_len == len
+                 && memcmp(got, want, len + 1) == 0 && got[len + 1] == '#'
+                 && memcmp(offsets, want_offsets, count * sizeof(size_t)) == 0
+                 && offsets[count] == 12345, "%s_bulk count %zu radix %u "
+                 "flags %d: \"%.60s\", want \"%.60s\"",
+                 sig ? "itoa" : "utoa", count, radix, flags, got, want);
+    /* offsets and len are optional. */
+    const int r2 = sig
+      ? nuconv_do_itoa_bulk((const int64_t*)src, count, got, NULL, NULL, sep,
+                            radix, flags)
+      : nuconv_do_utoa_bulk(src, count, got, NULL, NULL, sep, radix, flags);
+    NUCONV_CHECK(r2 == NUCONV_OK && strcmp(got, want) == 0,
+                 "%s_bulk without offsets", sig ? "itoa" : "utoa");
+  }
+  const int64_t one = 1;
+  char buf[8];
+  NUCONV_CHECK(nuconv_itoa_bulk_len(&one, 1, ",", 37, 0) == 0
+               && nuconv_do_itoa_bulk(&one, 1, buf, NULL, NULL, ",", 37, 0)
+                  == -NUCONV_ERROR_RADIX, "radix 37");
+}
+
+int main(void)
+{
+  test_random();
+  test_cases();
+  test_format();
+  return nuconv_test_result("bulk");
+}
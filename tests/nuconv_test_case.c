@@ -0,0 +1,102 @@
+#include "nuconv_test.h"
+
+/* Compares the buffer case conversions under every tier with a byte loop
+   that folds only ASCII letters. */
+
+static int tiers[NUCONV_TIER_AVX2 + 1];
+static int ntiers;
+
+static char ref_case(char c, bool upper)
+{
+  if (upper && c >= 'a' && c <= 'z') {
+    return (char)(c - 32);
+  }
+  if (!upper && c >= 'A' && c <= 'Z') {
+    return (char)(c + 32);
+  }
+  return c;
+}
+
+/* Letters around the case boundaries ('@', '[', '`', '{') are the likely
+   mistakes, so they are drawn as often as random bytes. */
+static void random_text(char* buf, size_t n)
+{
+  static const char edges[] = "@AZ[`az{Mm";
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] = nuconv_test_rand() % 2
+      ? edges[nuconv_test_rand() % (sizeof(edges) - 1)]
+      : (char)nuconv_test_rand();
+  }
+}
+
+/* Converts src[0, n) in place and into a separate buffer under each tier;
+   the bytes around the destination must stay untouched. */
+static void check(const char* src, size_t n, bool upper)
+{
+  char want[600];
+  char got[600 + 64];
+  for (size_t i = 0; i < n; ++i) {
+    want[i] = ref_case(src[i], upper);
+  }
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    const size_t off = 1 + (size_t)(nuconv_test_rand() % 31);
+    memset(got, '#', sizeof(got));
+    memcpy(got + off, src, n);
+    char* r = upper ? nuconv_memupper(got + off, n)
+                    : nuconv_memlower(got + off, n);
+    NUCONV_CHECK(r == got + off && memcmp(got + off, want, n) == 0
+                 && got[off - 1] == '#' && got[off + n] == '#',
+                 "tier %d mem%s length %zu", tiers[i],
+                 upper ? "upper" : "lower", n);
+    memset(got, '#', sizeof(got));
+    r = (char*)(upper ? nuconv_memcpy_upper(got + off, src, n)
+                      : nuconv_memcpy_lower(got + off, src, n));
+    NUCONV_CHECK(r == got + off && memcmp(got + off, want, n) == 0
+                 && got[off - 1] == '#' && got[off + n] == '#',
+                 "tier %d memcpy_%s length %zu", tiers[i],
+                 upper ? "upper" : "lower", n);
+    memcpy(got + off, src, n);
+    r = (char*)(upper ? nuconv_memcpy_upper(got + off, got + off, n)
+                      : nuconv_memcpy_lower(got + off, got + off, n));
+    NUCONV_CHECK(r == got + off && memcmp(got + off, want, n) == 0,
+                 "tier %d memcpy_%s in place length %zu", tiers[i],
+                 upper ? "upper" : "lower", n);
+  }
+}
+
+static void test_lengths(void)
+{
+  char* const guard = nuconv_test_guard_page(600);
+  char buf[600];
+  for (size_t n = 0; n <= 520; ++n) {
+    for (int rep = 0; rep < 4; ++rep) {
+      char* const src = guard != NULL && rep % 2 ? guard - n : buf + rep;
+      random_text(src, n);
+      check(src, n, rep < 2);
+    }
+  }
+}
+
+/* Every byte value at every position of a few vectors. */
+static void test_bytes(void)
+{
+  char buf[100];
+  memset(buf, 'q', sizeof(buf));
+  for (unsigned c = 0; c < 256; ++c) {
+    for (size_t at = 0; at < sizeof(buf); at += 1 + at % 5) {
+      buf[at] = (char)c;
+      check(buf, sizeof(buf), false);
+      check(buf, sizeof(buf), true);
+      buf[at] = 'q';
+    }
+  }
+}
+
+int main(void)
+{
+  ntiers = nuconv_test_tiers(tiers);
+  test_lengths();
+  test_bytes();
+  return nuconv_test_result("case");
+}
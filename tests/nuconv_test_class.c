@@ -0,0 +1,129 @@
+#include "nuconv_test.h"
+
+/* Compares memspn, memcspn and memclass under every tier with a byte loop
+   over nuconv_ctype, for single classes and random unions of them. */
+
+static int tiers[NUCONV_TIER_AVX2 + 1];
+static int ntiers;
+
+static const int classes[] = {
+  NUCONV_ALNUM, NUCONV_ALPHA, NUCONV_LOWER, NUCONV_UPPER, NUCONV_DIGIT,
+  NUCONV_XDIGIT, NUCONV_CNTRL, NUCONV_GRAPH, NUCONV_SPACE, NUCONV_BLANK,
+  NUCONV_PRINT, NUCONV_PUNCT,
+};
+#define NCLASSES (sizeof(classes) / sizeof(*classes))
+
+static bool member(char c, int mask)
+{
+  return (nuconv_ctype[(unsigned char)c] & mask) != 0;
+}
+
+static int random_mask(void)
+{
+  int mask = classes[nuconv_test_rand() % NCLASSES];
+  while (nuconv_test_rand() % 3 == 0) {
+    mask |= classes[nuconv_test_rand() % NCLASSES];
+  }
+  return mask;
+}
+
+/* A run of member (or non-member) bytes broken by one byte of the other
+   kind at a random point, or not at all; every byte value can appear. */
+static void random_run(char* buf, size_t n, int mask, bool accept)
+{
+  const size_t brk = (size_t)(nuconv_test_rand() % (n + 1 + n / 4));
+  for (size_t i = 0; i < n; ++i) {
+    char c;
+    do {
+      c = (char)nuconv_test_rand();
+    } while (member(c, mask) != (i == brk ? !accept : accept)
+             && nuconv_test_rand() % 64 != 0);
+    buf[i] = c;
+  }
+}
+
+static void check_span(const char* buf, size_t n, int mask)
+{
+  size_t spn = 0;
+  while (spn < n && member(buf[spn], mask)) {
+    ++spn;
+  }
+  size_t cspn = 0;
+  while (cspn < n && !member(buf[cspn], mask)) {
+    ++cspn;
+  }
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    const size_t gs = nuconv_memspn(buf, n, mask);
+    const size_t gc = nuconv_memcspn(buf, n, mask);
+    NUCONV_CHECK(gs == spn && gc == cspn, "tier %d mask %#x length %zu: "
+                 "span %zu/%zu, want %zu/%zu", tiers[i], mask, n, gs, gc,
+                 spn, cspn);
+  }
+}
+
+/* Bit i % 64 of word i / 64 is buf[i]'s membership; bits past n in the last
+   word are clear and the word after it is untouched. */
+static void check_class(const char* buf, size_t n, int mask)
+{
+  uint64_t want[10] = {0};
+  uint64_t got[10];
+  const size_t words = (n + 63) / 64;
+  for (size_t i = 0; i < n; ++i) {
+    want[i / 64] |= (uint64_t)member(buf[i], mask) << (i % 64);
+  }
+  want[words] = 0xA5A5A5A5A5A5A5A5ull;
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    memset(got, 0xA5, sizeof(got));
+    nuconv_memclass(buf, n, mask, got);
+    for (size_t w = 0; w <= words; ++w) {
+      NUCONV_CHECK(got[w] == want[w], "tier %d mask %#x length %zu word "
+                   "%zu: %016" PRIx64 ", want %016" PRIx64, tiers[i], mask,
+                   n, w, got[w], want[w]);
+    }
+  }
+}
+
+static void test_lengths(void)
+{
+  char* const guard = nuconv_test_guard_page(600);
+  char buf[600];
+  for (size_t n = 0; n <= 520; ++n) {
+    for (int rep = 0; rep < 8; ++rep) {
+      const int mask = rep < 2 ? classes[nuconv_test_rand() % NCLASSES]
+                               : random_mask();
+      char* const p = guard != NULL && rep % 2 ? guard - n
+                                               : buf + rep * 5;
+      random_run(p, n, mask, rep % 4 < 2);
+      check_span(p, n, mask);
+      check_class(p, n, mask);
+    }
+  }
+}
+
+/* Every byte value in place of a member, around the vector and word
+   boundaries. */
+static void test_bytes(void)
+{
+  char buf[160];
+  memset(buf, 'a', sizeof(buf));
+  for (unsigned c = 0; c < 256; ++c) {
+    for (size_t at = 0; at < 140; at += 1 + at % 3) {
+      buf[at] = (char)c;
+      for (size_t k = 0; k < NCLASSES; ++k) {
+        check_span(buf, 140, classes[k]);
+        check_class(buf, 140, classes[k]);
+      }
+      buf[at] = 'a';
+    }
+  }
+}
+
+int main(void)
+{
+  ntiers = nuconv_test_tiers(tiers);
+  test_lengths();
+  test_bytes();
+  return nuconv_test_result("class");
+}
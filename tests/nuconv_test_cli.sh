@@ -0,0 +1,158 @@
+#!/bin/sh
+# Usage: nuconv_test_cli.sh NUCONV SCRATCH_DIR
+# Runs the nuconv command-line converter over files and pipes and checks
+# its output, exit status and diagnostics.
+
+nuconv=$1
+dir=$2
+fails=0
+
+mkdir -p "$dir" || exit 1
+
+fail()
+{
+  fails=$((fails + 1))
+  echo "FAIL: $*" >&2
+}
+
+# A conversion error before end of piped input stops the reader while it
+# may still be blocked in read(); the command must fail promptly with the
+# right diagnostic and leave the reader to clean up on its own.
+test_early_error_on_pipe()
+{
+  (printf 'zz\n'; seq 1 300000; sleep 0.5; seq 1 10) \
+    | "$nuconv" parse -o "$dir/early.bin" 2> "$dir/early.err"
+  status=$?
+  [ "$status" -eq 1 ] || fail "early error on pipe: exit $status"
+  grep -q 'value 1: invalid character' "$dir/early.err" \
+    || fail "early error on pipe: $(cat "$dir/early.err")"
+
+  (seq 1 300000; printf '99999999999999999999\n'; sleep 0.5; seq 1 10) \
+    | "$nuconv" parse -o "$dir/early.bin" 2> "$dir/early.err"
+  status=$?
+  [ "$status" -eq 1 ] || fail "late overflow on pipe: exit $status"
+  grep -q 'value 300001: ' "$dir/early.err" \
+    || fail "late overflow on pipe: $(cat "$dir/early.err")"
+}
+
+# Limits and a few inner values for each width and signedness, one per line
+# as format prints them.
+values()
+{
+  case $1 in
+    i8) echo -128 -127 -1 0 1 100 127 ;;
+    i16) echo -32768 -32767 -1 0 1 12345 32767 ;;
+    i32) echo -2147483648 -2147483647 -1 0 1 123456789 2147483647 ;;
+    i64) echo -9223372036854775808 -9223372036854775807 -1 0 1 \
+              1234567890123456789 9223372036854775807 ;;
+    u8) echo 0 1 127 128 254 255 ;;
+    u16) echo 0 1 32767 32768 65534 65535 ;;
+    u32) echo 0 1 2147483647 2147483648 4294967294 4294967295 ;;
+    u64) echo 0 1 9223372036854775807 9223372036854775808 \
+              18446744073709551614 18446744073709551615 ;;
+  esac | tr ' ' '\n'
+}
+
+# The smallest value out of range at each width, and its index in the input
+# "1 2 VALUE".
+out_of_range()
+{
+  case $1 in
+    i8) echo 128 ;;
+    i16) echo -32769 ;;
+    i32) echo 2147483648 ;;
+    i64) echo -9223372036854775809 ;;
+    u8) echo 256 ;;
+    u16) echo 65536 ;;
+    u32) echo 4294967296 ;;
+    u64) echo 18446744073709551616 ;;
+  esac
+}
+
+# parse then format gives the input back, and mapped files, --stream and
+# pipes produce byte-identical output in both directions.
+test_round_trip()
+{
+  for type in i8 i16 i32 i64 u8 u16 u32 u64; do
+    width=${type#?}
+    opts="-w $width"
+    [ "${type%%[0-9]*}" = u ] && opts="$opts -u"
+    values $type > "$dir/$type.txt"
+    "$nuconv" parse $opts -o "$dir/$type.bin" "$dir/$type.txt" \
+      || fail "$type: parse exit $?"
+    size=$(wc -c < "$dir/$type.bin")
+    [ "$size" -eq $(($(wc -l < "$dir/$type.txt") * width / 8)) ] \
+      || fail "$type: parse wrote $size bytes"
+    "$nuconv" parse $opts --stream -o "$dir/$type.stream.bin" "$dir/$type.txt"
+    cmp -s "$dir/$type.bin" "$dir/$type.stream.bin" \
+      || fail "$type: parse --stream differs"
+    "$nuconv" parse $opts < "$dir/$type.txt" > "$dir/$type.pipe.bin"
+    cmp -s "$dir/$type.bin" "$dir/$type.pipe.bin" \
+      || fail "$type: parse from a pipe differs"
+
+    "$nuconv" format $opts -o "$dir/$type.out" "$dir/$type.bin" \
+      || fail "$type: format exit $?"
+    cmp -s "$dir/$type.txt" "$dir/$type.out" \
+      || fail "$type: round trip gives $(tr '\n' ' ' < "$dir/$type.out")"
+    "$nuconv" format $opts --stream -o "$dir/$type.stream.out" \
+      "$dir/$type.bin"
+    cmp -s "$dir/$type.out" "$dir/$type.stream.out" \
+      || fail "$type: format --stream differs"
+    "$nuconv" format $opts < "$dir/$type.bin" > "$dir/$type.pipe.out"
+    cmp -s "$dir/$type.out" "$dir/$type.pipe.out" \
+      || fail "$type: format from a pipe differs"
+  done
+}
+
+# Bad values fail with exit 1 naming the value's index (empty fields are
+# skipped and not counted), whichever way the input is read.
+expect_error()
+{
+  name=$1
+  pattern=$2
+  shift 2
+  "$@" > /dev/null 2> "$dir/error.err" < "$dir/error.txt"
+  status=$?
+  [ "$status" -eq 1 ] || fail "$name: exit $status"
+  grep -q "$pattern" "$dir/error.err" \
+    || fail "$name: $(cat "$dir/error.err")"
+}
+
+test_errors()
+{
+  for type in i8 i16 i32 i64 u8 u16 u32 u64; do
+    opts="-w ${type#?}"
+    [ "${type%%[0-9]*}" = u ] && opts="$opts -u"
+    printf '1 2\n\n%s 4\n' "$(out_of_range $type)" > "$dir/error.txt"
+    for mode in "$dir/error.txt" "--stream $dir/error.txt" -; do
+      expect_error "$type out of range ($mode)" \
+        'value 3: value out of range' "$nuconv" parse $opts $mode
+    done
+  done
+  printf '1,2,,3,x4,5\n' > "$dir/error.txt"
+  for mode in "$dir/error.txt" "--stream $dir/error.txt" -; do
+    expect_error "invalid ($mode)" 'value 4: invalid character' \
+      "$nuconv" parse $mode
+  done
+}
+
+# Binary input whose size is not a multiple of the width is rejected.
+test_partial_element()
+{
+  printf 'abcdefg' > "$dir/error.txt"
+  for width in 16 32 64; do
+    for mode in "$dir/error.txt" "--stream $dir/error.txt" -; do
+      expect_error "size 7 at width $width ($mode)" \
+        "is not a multiple of $((width / 8)) bytes" \
+        "$nuconv" format -w $width $mode
+    done
+  done
+}
+
+test_early_error_on_pipe
+test_round_trip
+test_errors
+test_partial_element
+
+echo "cli: $fails failure(s)"
+[ "$fails" -eq 0 ]
@@ -0,0 +1,44 @@
+#include "nuconv_test.h"
+
+#include <ctype.h>
+#include <locale.h>
+
+/* Compares the classification and case mapping with libc in the C locale
+   for every byte value and EOF, through both the inline macros and the
+   exported functions. */
+
+#define CHECK_CLASS(name)                                                     \
+  do {                                                                        \
+    const bool want = name(c) != 0;                                           \
+    NUCONV_CHECK((nuconv_##name(c) != 0) == want                              \
+                 && ((nuconv_##name)(c) != 0) == want,                        \
+                 #name "(%d): want %d", c, want);                             \
+  } while (0)
+
+int main(void)
+{
+  setlocale(LC_ALL, "C");
+  for (int c = EOF; c < 256; ++c) {
+    CHECK_CLASS(isalnum);
+    CHECK_CLASS(isalpha);
+    CHECK_CLASS(islower);
+    CHECK_CLASS(isupper);
+    CHECK_CLASS(isdigit);
+    CHECK_CLASS(isxdigit);
+    CHECK_CLASS(iscntrl);
+    CHECK_CLASS(isgraph);
+    CHECK_CLASS(isspace);
+    CHECK_CLASS(isblank);
+    CHECK_CLASS(isprint);
+    CHECK_CLASS(ispunct);
+    NUCONV_CHECK(nuconv_tolower(c) == tolower(c)
+                 && (nuconv_tolower)(c) == tolower(c),
+                 "tolower(%d): %d/%d, want %d", c, nuconv_tolower(c),
+                 (nuconv_tolower)(c), tolower(c));
+    NUCONV_CHECK(nuconv_toupper(c) == toupper(c)
+                 && (nuconv_toupper)(c) == toupper(c),
+                 "toupper(%d): %d/%d, want %d", c, nuconv_toupper(c),
+                 (nuconv_toupper)(c), toupper(c));
+  }
+  return nuconv_test_result("ctype");
+}
@@ -0,0 +1,197 @@
+#include "nuconv_test.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+static double from_bits(uint64_t bits)
+{
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+static uint64_t to_bits(double d)
+{
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+/* nuconv_do_atod must agree bit for bit with strtod, including the stop
+   position and the sign of zero, and report overflow when a finite number
+   rounds to infinity. */
+static void check_atod(const char* str)
+{
+  const char* lead = str;
+  while (*lead == ' ' || *lead == '\t' || *lead == '-' || *lead == '+') {
+    ++lead;
+  }
+  const bool literal = (*lead | 0x20) == 'i';
+  char* want_stop;
+  const double want = strtod(str, &want_stop);
+  const char* stop;
+  double got;
+  const int r = nuconv_do_atod(&got, str, NULL, &stop, 0);
+  NUCONV_CHECK(to_bits(got) == to_bits(want) && stop == want_stop,
+               "\"%.60s\": %a stop %td, want %a stop %td", str, got,
+               stop - str, want, want_stop - str);
+  NUCONV_CHECK(r == (isinf(want) && !literal ? NUCONV_WARN_OVERFLOW
+                                              : NUCONV_OK),
+               "\"%.60s\": status %d", str, r);
+}
+
+static void test_atod_fixed(void)
+{
+  static const char* const cases[] = {
+    "0", "-0", "0.0e10", "1", "-1.5", "3.14159", ".5", "5.", "1e0", "1E+2",
+    "123456789012345678901234567890", "0.1", "0.3",
+    "2.2250738585072011e-308", "2.2250738585072014e-308",
+    "4.9406564584124654e-324", "2.4703282292062327e-324",
+    "2.4703282292062328e-324", "1e-324", "1e-400", "1.7976931348623157e308",
+    "1.7976931348623158e308", "1.7976931348623159e308", "1e309", "-1e400",
+    "9007199254740993", "9007199254740992.5", "1e22", "1e23", "8.5e-1x",
+    "1e", "1e+", "1.5e-", "inf", "-Infinity", "INF", "infinit", "nan",
+    "  42", "\t-7.25e-3 rest",
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(*cases); ++i) {
+    check_atod(cases[i]);
+  }
+  double d;
+  NUCONV_CHECK(nuconv_do_atod(&d, "NaN", NULL, NULL, 0) == NUCONV_OK
+               && isnan(d), "nan");
+}
+
+/* Long decimal expansions of random doubles, with the trailing digits
+   perturbed, exercise the fast paths and the round-to-nearest decisions. */
+static void test_atod_random(void)
+{
+  char buf[64];
+  for (int iter = 0; iter < 300000; ++iter) {
+    double d;
+    do {
+      d = from_bits(nuconv_test_rand());
+    } while (isnan(d) || isinf(d));
+    const int digits = 1 + (int)(nuconv_test_rand() % 25);
+    snprintf(buf, sizeof(buf), "%.*e", digits - 1, d);
+    if (nuconv_test_rand() % 2) {
+      char* e = strchr(buf, 'e');
+      if (e[-1] != '.' && e - buf > 2) {
+        e[-1] = (char)('0' + nuconv_test_rand() % 10);
+      }
+    }
+    check_atod(buf);
+  }
+}
+
+#if LDBL_MANT_DIG >= 64 && LDBL_MAX_EXP > DBL_MAX_EXP
+/* Exact midpoints between adjacent doubles, printed in full, must round to
+   even; they need more digits than any fast path handles. */
+static void test_atod_halfway(void)
+{
+  static char buf[1200];
+  for (int iter = 0; iter < 2000; ++iter) {
+    double d;
+    do {
+      d = fabs(from_bits(nuconv_test_rand()));
+    } while (isnan(d) || isinf(d) || d == DBL_MAX);
+    const long double mid = ((long double)d + nextafter(d, INFINITY)) / 2;
+    snprintf(buf, sizeof(buf), "%.1100Lg", mid);
+    check_atod(buf);
+  }
+}
+#endif
+
+/* Significant digits of a nuconv_do_dtoa result. */
+static int significant_digits(const char* s)
+{
+  int n = 0;
+  int zeros = 0;
+  bool lead = true;
+  for (; *s != '\0' && *s != 'e'; ++s) {
+    if (*s < '0' || *s > '9') {
+      continue;
+    }
+    if (*s == '0' && lead) {
+      continue;
+    }
+    lead = false;
+    if (*s == '0') {
+      ++zeros;
+    } else {
+      n += zeros + 1;
+      zeros = 0;
+    }
+  }
+  return n == 0 ? 1 : n;
+}
+
+/* Every finite double formats to a string that parses back to it, with no
+   fewer digits possible: the %.*e rendering with one digit less never round
+   trips. */
+static void test_dtoa_round_trip(void)
+{
+  char buf[NUCONV_DTOA_BUFSIZE];
+  char shorter[64];
+  for (int iter = 0; iter < 300000; ++iter) {
+    uint64_t bits = nuconv_test_rand();
+    if (iter % 4 == 0) {
+      bits &= 0x800FFFFFFFFFFFFFull; /* subnormals and zero */
+    }
+    const double d = from_bits(bits);
+    if (isnan(d) || isinf(d)) {
+      continue;
+    }
+    const int len = nuconv_do_dtoa(d, buf, 0);
+    NUCONV_CHECK(len == (int)strlen(buf) && len < NUCONV_DTOA_BUFSIZE,
+                 "%a: length %d", d, len);
+    const double back = strtod(buf, NULL);
+    NUCONV_CHECK(to_bits(back) == to_bits(d), "%a: \"%s\" reads as %a", d,
+                 buf, back);
+    double parsed;
+    nuconv_do_atod(&parsed, buf, NULL, NULL, 0);
+    NUCONV_CHECK(to_bits(parsed) == to_bits(d), "%a: \"%s\" parses as %a", d,
+                 buf, parsed);
+    const int digits = significant_digits(buf);
+    if (digits > 1) {
+      snprintf(shorter, sizeof(shorter), "%.*e", digits - 2, d);
+      NUCONV_CHECK(strtod(shorter, NULL) != d, "%a: \"%s\" but \"%s\"", d,
+                   buf, shorter);
+    }
+  }
+}
+
+static void test_dtoa_fixed(void)
+{
+  static const struct {
+    double value;
+    const char* text;
+  } cases[] = {
+    {0.0, "0"}, {-0.0, "-0"}, {1.0, "1"}, {0.1, "0.1"}, {-2.5, "-2.5"},
+    {1e-6, "0.000001"}, {1e-7, "1e-7"}, {1e20, "100000000000000000000"},
+    {1e21, "1e+21"}, {5e-324, "5e-324"}, {1.7976931348623157e308,
+    "1.7976931348623157e+308"}, {123456.789, "123456.789"},
+  };
+  char buf[NUCONV_DTOA_BUFSIZE];
+  for (size_t i = 0; i < sizeof(cases) / sizeof(*cases); ++i) {
+    nuconv_do_dtoa(cases[i].value, buf, 0);
+    NUCONV_CHECK(strcmp(buf, cases[i].text) == 0, "%a: \"%s\", want \"%s\"",
+                 cases[i].value, buf, cases[i].text);
+  }
+  nuconv_do_dtoa(-INFINITY, buf, 0);
+  NUCONV_CHECK(strcmp(buf, "-inf") == 0, "\"%s\"", buf);
+  nuconv_do_dtoa(NAN, buf, NUCONV_FLAG_UPPERCASE);
+  NUCONV_CHECK(strcmp(buf, "NAN") == 0, "\"%s\"", buf);
+}
+
+int main(void)
+{
+  test_atod_fixed();
+  test_atod_random();
+#if LDBL_MANT_DIG >= 64 && LDBL_MAX_EXP > DBL_MAX_EXP
+  test_atod_halfway();
+#endif
+  test_dtoa_fixed();
+  test_dtoa_round_trip();
+  return nuconv_test_result("float");
+}
@@ -0,0 +1,180 @@
+#include "nuconv_test.h"
+
+#include <nuconv.hpp>
+
+/* Compares the nuconv.hpp templates with the C functions of the same width
+   on random text and values, and checks that they work in constant
+   expressions. */
+
+template <typename T>
+constexpr T parsed(const char* str)
+{
+  T v = 0;
+  nuconv::parse(v, str);
+  return v;
+}
+
+template <typename T, unsigned Radix>
+constexpr int parsed_status(std::string_view str)
+{
+  T v = 0;
+  return nuconv::parse<T, Radix>(v, str);
+}
+
+template <typename T, unsigned Radix>
+constexpr char formatted_first(T value)
+{
+  char buf[nuconv::buffer_size<T, Radix>] = {};
+  nuconv::format<T, Radix>(value, buf, NUCONV_FLAG_UPPERCASE);
+  return buf[0];
+}
+
+static_assert(parsed<int>("-42") == -42);
+static_assert(parsed<std::int64_t>("-9223372036854775808") == INT64_MIN);
+static_assert(parsed<std::uint8_t>("1_000") == UINT8_MAX);
+static_assert(parsed_status<std::uint16_t, 16>("ffff") == NUCONV_OK);
+static_assert(parsed_status<std::uint16_t, 16>("10000")
+              == NUCONV_WARN_OVERFLOW);
+static_assert(parsed_status<int, 10>("") == -NUCONV_ERROR_EMPTY);
+static_assert(parsed_status<int, 10>("x") == -NUCONV_ERROR_INVALID_CHARACTER);
+static_assert(formatted_first<std::uint64_t, 16>(0xF0) == 'F');
+static_assert(formatted_first<std::int8_t, 10>(-1) == '-');
+static_assert(nuconv::buffer_size<std::int8_t> == 5);
+static_assert(nuconv::buffer_size<std::uint8_t, 2> == 9);
+static_assert(nuconv::buffer_size<std::int64_t> == 21);
+static_assert(nuconv::buffer_size<std::uint64_t> == 21);
+static_assert(nuconv::buffer_size<std::uint64_t, 2> == 65);
+static_assert(nuconv::buffer_size<std::int64_t, 2> == 66);
+static_assert(nuconv::buffer_size<std::uint64_t, 36> == 14);
+
+/* The C functions of each width. */
+template <typename T>
+struct c_api;
+
+#define C_API(T, s, bits)                                                     \
+template <>                                                                   \
+struct c_api<T> {                                                             \
+  static int parse(T* dst, const char* begin, const char* end,                \
+                   const char** stop, unsigned radix)                         \
+  {                                                                           \
+    return nuconv_do_ato##s##bits(dst, begin, end, stop, radix, 0);           \
+  }                                                                           \
+  static int format(T value, char* buf, unsigned radix, int flags)            \
+  {                                                                           \
+    return nuconv_do_##s##toa##bits(value, buf, radix, flags);                \
+  }                                                                           \
+};
+
+C_API(std::int8_t, i, 8)
+C_API(std::int16_t, i, 16)
+C_API(std::int32_t, i, 32)
+C_API(std::int64_t, i, 64)
+C_API(std::uint8_t, u, 8)
+C_API(std::uint16_t, u, 16)
+C_API(std::uint32_t, u, 32)
+C_API(std::uint64_t, u, 64)
+
+/* Digits of radix in either case, with occasional signs, skip characters
+   and characters that stop the parse; up to 24 digits so that every width
+   overflows. */
+static std::size_t random_text(char* buf, unsigned radix)
+{
+  static const char lower[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  static const char upper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  static const char other[] = "-+_ \t\n!.zZ\x80";
+  std::size_t n = 0;
+  const unsigned digits = (unsigned)(nuconv_test_rand() % 25);
+  for (unsigned i = 0; i < digits; ++i) {
+    if (nuconv_test_rand() % 8 == 0) {
+      buf[n++] = other[nuconv_test_rand() % (sizeof(other) - 1)];
+    }
+    const unsigned d = (unsigned)(nuconv_test_rand() % radix);
+    buf[n++] = nuconv_test_rand() % 2 ? lower[d] : upper[d];
+  }
+  buf[n] = '\0';
+  return n;
+}
+
+template <typename T, unsigned Radix>
+static void test_parse()
+{
+  char buf[64];
+  for (int iter = 0; iter < 20000; ++iter) {
+    const std::size_t len = random_text(buf, Radix);
+    T want = 0;
+    const char* want_stop = nullptr;
+    const int wr = c_api<T>::parse(&want, buf, buf + len, &want_stop, Radix);
+    T got = 0;
+    const char* stop = nullptr;
+    int r = nuconv::parse_n<T, Radix>(got, buf, buf + len, &stop);
+    NUCONV_CHECK(r == wr && got == want && stop == want_stop,
+                 "parse_n \"%s\" radix %u size %zu: %d/%" PRId64 "/+%td, "
+                 "want %d/%" PRId64 "/+%td", buf, Radix, sizeof(T), r,
+                 (int64_t)got, stop - buf, wr, (int64_t)want,
+                 want_stop - buf);
+    got = 0;
+    r = nuconv::parse<T, Radix>(got, std::string_view(buf, len), &stop);
+    NUCONV_CHECK(r == wr && got == want && stop == want_stop,
+                 "parse(string_view) \"%s\" radix %u size %zu", buf, Radix,
+                 sizeof(T));
+    const int wr0 = c_api<T>::parse(&want, buf, nullptr, &want_stop, Radix);
+    got = 0;
+    r = nuconv::parse<T, Radix>(got, buf, &stop);
+    NUCONV_CHECK(r == wr0 && got == want && stop == want_stop,
+                 "parse(const char*) \"%s\" radix %u size %zu", buf, Radix,
+                 sizeof(T));
+  }
+}
+
+template <typename T, unsigned Radix>
+static void test_format()
+{
+  char want[80];
+  char got[nuconv::buffer_size<T, Radix> + 1];
+  for (int iter = 0; iter < 20000; ++iter) {
+    T v = static_cast<T>(nuconv_test_rand() >> (nuconv_test_rand() % 64));
+    if (iter < 4) {
+      const T edges[] = {0, 1, std::numeric_limits<T>::min(),
+                         std::numeric_limits<T>::max()};
+      v = edges[iter];
+    }
+    const int flags = (nuconv_test_rand() % 2 ? NUCONV_FLAG_UPPERCASE : 0)
+      | (nuconv_test_rand() % 4 == 0 ? NUCONV_FLAG_ABS : 0);
+    const int wn = c_api<T>::format(v, want, Radix, flags);
+    memset(got, '#', sizeof(got));
+    const int n = nuconv::format<T, Radix>(v, got, flags);
+    NUCONV_CHECK(n == wn && strcmp(got, want) == 0
+                 && got[sizeof(got) - 1] == '#',
+                 "format %" PRId64 " radix %u size %zu flags %d: \"%s\", "
+                 "want \"%s\"", (int64_t)v, Radix, sizeof(T), flags, got,
+                 want);
+  }
+}
+
+template <typename T>
+static void test_type()
+{
+  test_parse<T, 2>();
+  test_parse<T, 7>();
+  test_parse<T, 10>();
+  test_parse<T, 16>();
+  test_parse<T, 36>();
+  test_format<T, 2>();
+  test_format<T, 7>();
+  test_format<T, 10>();
+  test_format<T, 16>();
+  test_format<T, 36>();
+}
+
+int main()
+{
+  test_type<std::int8_t>();
+  test_type<std::int16_t>();
+  test_type<std::int32_t>();
+  test_type<std::int64_t>();
+  test_type<std::uint8_t>();
+  test_type<std::uint16_t>();
+  test_type<std::uint32_t>();
+  test_type<std::uint64_t>();
+  return nuconv_test_result("hpp");
+}
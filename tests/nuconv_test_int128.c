@@ -0,0 +1,149 @@
+#include "nuconv_test.h"
+
+#ifdef __SIZEOF_INT128__
+#define U128_MAX ((nuconv_uint128)-1)
+#define I128_MAX ((nuconv_int128)(U128_MAX >> 1))
+#define I128_MIN (-I128_MAX - 1)
+
+static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static void ref_format(char* buf, nuconv_uint128 mag, bool neg, unsigned radix)
+{
+  char tmp[136];
+  size_t n = 0;
+  do {
+    tmp[n++] = digits[(unsigned)(mag % radix)];
+    mag /= radix;
+  } while (mag != 0);
+  if (neg) {
+    *buf++ = '-';
+  }
+  while (n > 0) {
+    *buf++ = tmp[--n];
+  }
+  *buf = '\0';
+}
+
+/* Random numbers long enough to cross 128 bits in every radix (2^128 has 39
+   decimal digits), compared with the exact value saturated to the type. */
+static void test_random(bool sig)
+{
+  const nuconv_uint128 max = sig ? (nuconv_uint128)I128_MAX : U128_MAX;
+  char buf[160];
+  char got_text[136];
+  char want_text[136];
+  for (int iter = 0; iter < 200000; ++iter) {
+    const unsigned radix = 2 + (unsigned)(nuconv_test_rand() % 35);
+    const bool neg = sig && nuconv_test_rand() % 2;
+    nuconv_uint128 mag = 0;
+    bool big = false;
+    size_t n = 0;
+    if (neg) {
+      buf[n++] = '-';
+    }
+    /* Mostly around the digit count of the type's range in this radix. */
+    unsigned width = 0;
+    for (nuconv_uint128 m = U128_MAX; m != 0; m /= radix) {
+      ++width;
+    }
+    const unsigned count = nuconv_test_rand() % 4 == 0
+      ? 1 + (unsigned)(nuconv_test_rand() % width)
+      : width - 2 + (unsigned)(nuconv_test_rand() % 4);
+    for (unsigned i = 0; i < count; ++i) {
+      if (nuconv_test_rand() % 16 == 0) {
+        buf[n++] = '_';
+      }
+      const unsigned d = (unsigned)(nuconv_test_rand() % radix);
+      buf[n++] = digits[d];
+      if (big || mag > (U128_MAX - d) / radix) {
+        big = true;
+      } else {
+        mag = mag * radix + d;
+      }
+    }
+    buf[n] = '\0';
+    const bool over = big || mag > max + neg;
+    const nuconv_uint128 sat = over ? max + neg : mag;
+    const nuconv_uint128 want = neg ? 0 - sat : sat;
+    nuconv_uint128 got;
+    const char* stop;
+    int r;
+    if (sig) {
+      nuconv_int128 v;
+      r = nuconv_do_atoi128(&v, buf, buf + n, &stop, radix, 0);
+      got = (nuconv_uint128)v;
+    } else {
+      r = nuconv_do_atou128(&got, buf, buf + n, &stop, radix, 0);
+    }
+    if (got != want) {
+      ref_format(got_text, got, false, 16);
+      ref_format(want_text, want, false, 16);
+    }
+    NUCONV_CHECK(got == want && stop == buf + n
+                 && r == (over ? NUCONV_WARN_OVERFLOW : NUCONV_OK),
+                 "\"%s\" radix %u: 0x%s/%d, want 0x%s", buf, radix,
+                 got == want ? "" : got_text, r,
+                 got == want ? "" : want_text);
+  }
+}
+
+static void test_edges(void)
+{
+  const nuconv_int128 iedges[] = {I128_MIN, I128_MIN + 1, -1, 0, 1,
+                                  I128_MAX - 1, I128_MAX};
+  const nuconv_uint128 uedges[] = {0, 1, (nuconv_uint128)1 << 64,
+                                   U128_MAX - 1, U128_MAX};
+  char buf[136];
+  char ref[136];
+  for (unsigned radix = 2; radix <= 36; ++radix) {
+    for (size_t i = 0; i < sizeof(iedges) / sizeof(*iedges); ++i) {
+      const nuconv_int128 v = iedges[i];
+      const int len = nuconv_do_itoa128(v, buf, radix, 0);
+      ref_format(ref, v < 0 ? 0 - (nuconv_uint128)v : (nuconv_uint128)v,
+                 v < 0, radix);
+      NUCONV_CHECK(strcmp(buf, ref) == 0 && len == (int)strlen(ref),
+                   "radix %u: \"%s\", want \"%s\"", radix, buf, ref);
+      nuconv_int128 back;
+      NUCONV_CHECK(nuconv_do_atoi128(&back, buf, NULL, NULL, radix, 0)
+                   == NUCONV_OK && back == v, "\"%s\" radix %u", buf, radix);
+    }
+    for (size_t i = 0; i < sizeof(uedges) / sizeof(*uedges); ++i) {
+      const nuconv_uint128 v = uedges[i];
+      const int len = nuconv_do_utoa128(v, buf, radix, 0);
+      ref_format(ref, v, false, radix);
+      NUCONV_CHECK(strcmp(buf, ref) == 0 && len == (int)strlen(ref),
+                   "radix %u: \"%s\", want \"%s\"", radix, buf, ref);
+      nuconv_uint128 back;
+      NUCONV_CHECK(nuconv_do_atou128(&back, buf, NULL, NULL, radix, 0)
+                   == NUCONV_OK && back == v, "\"%s\" radix %u", buf, radix);
+    }
+    /* One past either signed end saturates. */
+    nuconv_int128 got;
+    ref_format(ref, (nuconv_uint128)I128_MAX + 2, true, radix);
+    NUCONV_CHECK(nuconv_do_atoi128(&got, ref, NULL, NULL, radix, 0)
+                 == NUCONV_WARN_OVERFLOW && got == I128_MIN,
+                 "\"%s\" radix %u", ref, radix);
+    ref_format(ref, (nuconv_uint128)I128_MAX + 1, false, radix);
+    NUCONV_CHECK(nuconv_do_atoi128(&got, ref, NULL, NULL, radix, 0)
+                 == NUCONV_WARN_OVERFLOW && got == I128_MAX,
+                 "\"%s\" radix %u", ref, radix);
+    /* U128_MAX followed by one more digit. */
+    nuconv_uint128 ugot;
+    ref_format(ref, U128_MAX, false, radix);
+    strcat(ref, "0");
+    NUCONV_CHECK(nuconv_do_atou128(&ugot, ref, NULL, NULL, radix, 0)
+                 == NUCONV_WARN_OVERFLOW && ugot == U128_MAX,
+                 "\"%s\" radix %u", ref, radix);
+  }
+}
+#endif
+
+int main(void)
+{
+#ifdef __SIZEOF_INT128__
+  test_random(true);
+  test_random(false);
+  test_edges();
+#endif
+  return nuconv_test_result("int128");
+}
@@ -0,0 +1,141 @@
+#define _GNU_SOURCE 1
+
+#include "nuconv_test.h"
+
+/* Compares nuconv_memmem and nuconv_strstr with libc under every tier, on
+   small alphabets so that partial matches are frequent. */
+
+static int tiers[NUCONV_TIER_AVX2 + 1];
+static int ntiers;
+
+static void check(const char* h, size_t hlen, const char* n, size_t nlen)
+{
+  const char* want = (const char*)memmem(h, hlen, n, nlen);
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    const char* got = (const char*)nuconv_memmem(h, hlen, n, nlen);
+    NUCONV_CHECK(got == want, "tier %d memmem(\"%.*s\", \"%.*s\"): %td, "
+                 "want %td", tiers[i], (int)hlen, h, (int)nlen, n,
+                 got != NULL ? got - h : -1, want != NULL ? want - h : -1);
+  }
+}
+
+/* As check, for NUL-terminated h and n. */
+static void check_str(const char* h, const char* n)
+{
+  const char* want = strstr(h, n);
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    const char* got = nuconv_strstr(h, n);
+    NUCONV_CHECK(got == want, "tier %d strstr(\"%s\", \"%s\"): %td, "
+                 "want %td", tiers[i], h, n, got != NULL ? got - h : -1,
+                 want != NULL ? want - h : -1);
+  }
+}
+
+static void random_text(char* buf, size_t n, unsigned alphabet)
+{
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] = (char)('a' + nuconv_test_rand() % alphabet);
+  }
+}
+
+/* Needle lengths 0, 1 and 2 take their own paths; up to 32 bytes use the
+   vector kernels and longer ones the two-way search. */
+static size_t random_needle_len(void)
+{
+  switch (nuconv_test_rand() % 6) {
+  case 0: return (size_t)(nuconv_test_rand() % 3);
+  case 1: return 3 + (size_t)(nuconv_test_rand() % 14);
+  case 2: return 17 + (size_t)(nuconv_test_rand() % 16);
+  case 3: return 30 + (size_t)(nuconv_test_rand() % 5);
+  default: return (size_t)(nuconv_test_rand() % 100);
+  }
+}
+
+static void test_random(void)
+{
+  char hbuf[400];
+  char nbuf[120];
+  for (int iter = 0; iter < 200000; ++iter) {
+    const unsigned alphabet = 2 + (unsigned)(nuconv_test_rand() % 3);
+    const size_t off = (size_t)(nuconv_test_rand() % 64);
+    char* const h = hbuf + off;
+    const size_t hlen = (size_t)(nuconv_test_rand() % 300);
+    const size_t nlen = random_needle_len();
+    random_text(h, hlen, alphabet);
+    random_text(nbuf, nlen, alphabet);
+    /* Plant the needle, often at the very end of the haystack. */
+    if (nlen <= hlen && nuconv_test_rand() % 2) {
+      const size_t at = nuconv_test_rand() % 2
+        ? hlen - nlen
+        : (size_t)(nuconv_test_rand() % (hlen - nlen + 1));
+      memcpy(h + at, nbuf, nlen);
+      if (nlen != 0 && nuconv_test_rand() % 2) {
+        h[at + nlen - 1 - nuconv_test_rand() % nlen] ^= 1;
+      }
+    }
+    check(h, hlen, nbuf, nlen);
+    h[hlen] = '\0';
+    nbuf[nlen] = '\0';
+    check_str(h, nbuf);
+  }
+}
+
+/* A single match starting at each position around the 16- and 32-byte
+   block boundaries, in a haystack of the needle's first byte. */
+static void test_boundaries(void)
+{
+  char h[160];
+  char n[80];
+  for (size_t nlen = 1; nlen <= 70; ++nlen) {
+    memset(n, 'a', nlen);
+    n[nlen - 1] = 'b';
+    n[nlen] = '\0';
+    for (size_t at = 0; at + nlen <= 128; ++at) {
+      memset(h, 'a', 128);
+      memcpy(h + at, n, nlen);
+      h[128] = '\0';
+      check(h, 128, n, nlen);
+      check(h, at + nlen, n, nlen);
+      check(h, at + nlen - 1, n, nlen);
+      check_str(h, n);
+    }
+  }
+}
+
+/* Haystacks ending right before an unmapped page, with and without a match
+   at the tail. */
+static void test_page_end(void)
+{
+  char* const guard = nuconv_test_guard_page(512);
+  if (guard == NULL) {
+    return;
+  }
+  char n[120];
+  for (int iter = 0; iter < 20000; ++iter) {
+    const size_t hlen = (size_t)(nuconv_test_rand() % 512);
+    const size_t nlen = random_needle_len();
+    char* const h = guard - hlen;
+    random_text(h, hlen, 2);
+    random_text(n, nlen, 2);
+    if (nlen <= hlen && nuconv_test_rand() % 2) {
+      memcpy(guard - nlen, n, nlen);
+    }
+    check(h, hlen, n, nlen);
+    if (hlen != 0) {
+      guard[-1] = '\0';
+      n[nlen] = '\0';
+      check_str(h, n);
+    }
+  }
+}
+
+int main(void)
+{
+  ntiers = nuconv_test_tiers(tiers);
+  test_random();
+  test_boundaries();
+  test_page_end();
+  return nuconv_test_result("memmem");
+}
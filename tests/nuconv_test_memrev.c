@@ -0,0 +1,80 @@
+#include "nuconv_test.h"
+
+/* Reverses random buffers of every length up to a few vectors under every
+   tier and compares with a byte-by-byte reversal. */
+
+static int tiers[NUCONV_TIER_AVX2 + 1];
+static int ntiers;
+
+static void random_bytes(char* buf, size_t n)
+{
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] = (char)nuconv_test_rand();
+  }
+}
+
+/* Reverses buf[0, n) under each tier, both in place at buf and at the end
+   of the guard page when there is one. */
+static void check(char* buf, size_t n, char* guard)
+{
+  char src[600];
+  char want[600];
+  memcpy(src, buf, n);
+  for (size_t i = 0; i < n; ++i) {
+    want[i] = src[n - 1 - i];
+  }
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    memcpy(buf, src, n);
+    size_t r = nuconv_memrev(buf, n);
+    NUCONV_CHECK(memcmp(buf, want, n) == 0 && r == n / 2,
+                 "tier %d memrev length %zu at %p: returned %zu", tiers[i], n,
+                 (void*)buf, r);
+    if (guard != NULL) {
+      memcpy(guard - n, src, n);
+      r = nuconv_memrev(guard - n, n);
+      NUCONV_CHECK(memcmp(guard - n, want, n) == 0 && r == n / 2,
+                   "tier %d memrev length %zu at page end", tiers[i], n);
+    }
+  }
+}
+
+static void test_lengths(void)
+{
+  char* const guard = nuconv_test_guard_page(600);
+  char buf[600];
+  for (size_t n = 0; n <= 520; ++n) {
+    for (size_t off = 0; off < 32; off += 7) {
+      random_bytes(buf + off, n);
+      check(buf + off, n, off == 0 ? guard : NULL);
+    }
+  }
+}
+
+/* strrev stops at the NUL; bytes past it stay put. */
+static void test_strrev(void)
+{
+  char buf[600];
+  char want[600];
+  for (int iter = 0; iter < 20000; ++iter) {
+    const size_t n = (size_t)(nuconv_test_rand() % 520);
+    for (size_t i = 0; i < n; ++i) {
+      buf[i] = (char)(1 + nuconv_test_rand() % 255);
+      want[n - 1 - i] = buf[i];
+    }
+    memcpy(buf + n, "\0tail", 6);
+    memcpy(want + n, "\0tail", 6);
+    nuconv_set_tier(tiers[(size_t)nuconv_test_rand() % (size_t)ntiers]);
+    const size_t r = nuconv_strrev(buf);
+    NUCONV_CHECK(memcmp(buf, want, n + 6) == 0 && r == n / 2,
+                 "tier %d strrev length %zu", nuconv_get_tier(), n);
+  }
+}
+
+int main(void)
+{
+  ntiers = nuconv_test_tiers(tiers);
+  test_lengths();
+  test_strrev();
+  return nuconv_test_result("memrev");
+}
@@ -0,0 +1,148 @@
+#include "nuconv_test.h"
+
+#include <stdlib.h>
+
+/* Compares the parallel bulk parsers with the sequential ones on inputs
+   large enough to be split (the chunks are at least 64 KiB). */
+
+#define TEXT_SIZE (400u << 10)
+#define MAX_FIELDS (TEXT_SIZE / 2)
+
+static char* text;
+static uint64_t* want_dst;
+static uint64_t* got_dst;
+static int* want_status;
+static int* got_status;
+
+/* Mostly clean numbers with the occasional empty, invalid or overflowing
+   field; delims[0] separates most fields and the others appear too. */
+static size_t random_text(const char* delims, unsigned radix, bool errors,
+                          size_t size)
+{
+  static const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  const size_t ndelims = strlen(delims);
+  size_t n = 0;
+  while (n + 40 < size) {
+    const unsigned kind = errors ? (unsigned)(nuconv_test_rand() % 200) : 99;
+    if (kind == 0) {
+      text[n++] = 'x';
+    } else if (kind == 1) {
+      memset(text + n, (int)alphabet[radix - 1], 30);
+      n += 30;
+    } else if (kind != 2) {
+      if (nuconv_test_rand() % 4 == 0) {
+        text[n++] = '-';
+      }
+      const unsigned digits = 1 + (unsigned)(nuconv_test_rand() % 12);
+      for (unsigned i = 0; i < digits; ++i) {
+        text[n++] = alphabet[nuconv_test_rand() % radix];
+      }
+    }
+    text[n++] = nuconv_test_rand() % 4 == 0
+      ? delims[nuconv_test_rand() % ndelims]
+      : delims[0];
+  }
+  if (nuconv_test_rand() % 2) {
+    text[n++] = '7';
+  }
+  text[n] = '\0';
+  return n;
+}
+
+static void check(size_t len, const char* delims, unsigned radix, size_t cap,
+                  unsigned threads, bool sig, bool nul)
+{
+  const char* const end = nul ? NULL : text + len;
+  size_t want_count = cap;
+  size_t got_count = cap;
+  const char* want_stop;
+  const char* got_stop;
+  int want;
+  int got;
+  memset(got_dst, 0x5A, MAX_FIELDS * sizeof(*got_dst));
+  memset(got_status, 0x5A, MAX_FIELDS * sizeof(*got_status));
+  if (sig) {
+    want = nuconv_do_atoi_bulk((int64_t*)want_dst, want_status, &want_count,
+                               text, end, &want_stop, delims, radix, 0);
+    got = nuconv_do_atoi_bulk_parallel((int64_t*)got_dst, got_status,
+                                       &got_count, text, end, &got_stop,
+                                       delims, radix, 0, threads);
+  } else {
+    want = nuconv_do_atou_bulk(want_dst, want_status, &want_count, text, end,
+                               &want_stop, delims, radix, 0);
+    got = nuconv_do_atou_bulk_parallel(got_dst, got_status, &got_count, text,
+                                       end, &got_stop, delims, radix, 0,
+                                       threads);
+  }
+  NUCONV_CHECK(got == want && got_count == want_count
+               && got_stop == want_stop, "%s length %zu delims \"%s\" radix "
+               "%u count %zu threads %u%s: %d/%zu/+%td, want %d/%zu/+%td",
+               sig ? "atoi" : "atou", len, delims, radix, cap, threads,
+               nul ? " NULL end" : "", got, got_count, got_stop - text, want,
+               want_count, want_stop - text);
+  size_t diffs = 0;
+  for (size_t i = 0; i < want_count && i < got_count; ++i) {
+    diffs += got_dst[i] != want_dst[i] || got_status[i] != want_status[i];
+  }
+  NUCONV_CHECK(diffs == 0, "%s length %zu delims \"%s\" radix %u count %zu "
+               "threads %u: %zu fields differ", sig ? "atoi" : "atou", len,
+               delims, radix, cap, threads, diffs);
+  if (want_count < MAX_FIELDS) {
+    NUCONV_CHECK(got_dst[want_count] == 0x5A5A5A5A5A5A5A5Aull,
+                 "field %zu past the count written", want_count);
+  }
+}
+
+int main(void)
+{
+  /* Delimiter sets wider than the four the SWAR counter handles, and ones
+     with digits of the radix, which do not delimit. */
+  static const char* const delims[] = {",", "\n\t", ",;|\t\n ", "a,", "9\n"};
+  static const unsigned radixes[] = {10, 16, 8, 36};
+  static const unsigned threads[] = {2, 3, 4, 8};
+  text = (char*)malloc(TEXT_SIZE + 1);
+  want_dst = (uint64_t*)malloc(MAX_FIELDS * sizeof(*want_dst));
+  got_dst = (uint64_t*)malloc(MAX_FIELDS * sizeof(*got_dst));
+  want_status = (int*)malloc(MAX_FIELDS * sizeof(*want_status));
+  got_status = (int*)malloc(MAX_FIELDS * sizeof(*got_status));
+  if (text == NULL || want_dst == NULL || got_dst == NULL
+      || want_status == NULL || got_status == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+  for (int iter = 0; iter < 40; ++iter) {
+    const char* const d = delims[iter % 5];
+    const unsigned radix = radixes[nuconv_test_rand() % 4];
+    const size_t size = (size_t)(nuconv_test_rand() % TEXT_SIZE / 2)
+      + TEXT_SIZE / 2;
+    const size_t len = random_text(d, radix, iter % 3 != 0, size);
+    /* No limit, a limit in the middle, and one just short of the end. */
+    size_t cap = MAX_FIELDS;
+    if (iter % 4 == 1) {
+      cap = (size_t)(nuconv_test_rand() % (len / 8));
+    } else if (iter % 4 == 2) {
+      want_dst[0] = 0;
+      size_t fields = MAX_FIELDS;
+      nuconv_do_atou_bulk(want_dst, NULL, &fields, text, text + len, NULL, d,
+                          radix, 0);
+      cap = fields - 1;
+    }
+    const unsigned t = threads[nuconv_test_rand() % 4];
+    check(len, d, radix, cap, t, iter % 2, false);
+    check(len, d, radix, cap, t, iter % 2 == 0, iter % 3 == 2);
+  }
+  /* The radix error and a short input take the sequential path. */
+  check(random_text(",", 10, true, 1000), ",", 10, MAX_FIELDS, 4, true,
+        false);
+  size_t count = 1;
+  int64_t v;
+  NUCONV_CHECK(nuconv_do_atoi_bulk_parallel(&v, NULL, &count, text, NULL,
+                                            NULL, ",", 1, 0, 4)
+               == -NUCONV_ERROR_RADIX && count == 0, "radix 1");
+  free(text);
+  free(want_dst);
+  free(got_dst);
+  free(want_status);
+  free(got_status);
+  return nuconv_test_result("parallel");
+}
@@ -0,0 +1,141 @@
+#include "nuconv_test.h"
+
+/* Round-trips the power-of-two radixes under every tier against a
+   division-based reference, with the 64-bit limits and one past them. */
+
+static int tiers[NUCONV_TIER_AVX2 + 1];
+static int ntiers;
+
+static const char lower[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+static const char upper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void ref_format(char* buf, uint64_t mag, bool neg, unsigned radix,
+                       const char* alphabet)
+{
+  char tmp[72];
+  size_t n = 0;
+  do {
+    tmp[n++] = alphabet[mag % radix];
+    mag /= radix;
+  } while (mag != 0);
+  if (neg) {
+    *buf++ = '-';
+  }
+  while (n > 0) {
+    *buf++ = tmp[--n];
+  }
+  *buf = '\0';
+}
+
+/* Adds one to the digits of buf in radix, growing it by a digit if
+   needed. */
+static void ref_increment(char* buf, unsigned radix)
+{
+  size_t n = strlen(buf);
+  const size_t start = buf[0] == '-';
+  size_t i = n;
+  while (i > start) {
+    --i;
+    const unsigned d = (unsigned)(strchr(lower, buf[i]) - lower) + 1;
+    if (d < radix) {
+      buf[i] = lower[d];
+      return;
+    }
+    buf[i] = '0';
+  }
+  memmove(buf + start + 1, buf + start, n - start + 1);
+  buf[start] = '1';
+}
+
+static void check_value(uint64_t v, unsigned radix)
+{
+  char want[80];
+  char got[80];
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    for (int up = 0; up < 2; ++up) {
+      const int flags = up ? NUCONV_FLAG_UPPERCASE : 0;
+      ref_format(want, v, false, radix, up ? upper : lower);
+      int n = nuconv_do_utoa(v, got, radix, flags);
+      NUCONV_CHECK(n == (int)strlen(want) && strcmp(got, want) == 0,
+                   "tier %d utoa %" PRIx64 " radix %u: \"%s\", want \"%s\"",
+                   tiers[i], v, radix, got, want);
+      uint64_t back;
+      NUCONV_CHECK(nuconv_do_atou(&back, want, radix, 0) == NUCONV_OK
+                   && back == v, "tier %d atou \"%s\" radix %u", tiers[i],
+                   want, radix);
+
+      const int64_t s = (int64_t)v;
+      const bool neg = s < 0;
+      ref_format(want, neg ? 0 - v : v, neg, radix, up ? upper : lower);
+      n = nuconv_do_itoa(s, got, radix, flags);
+      NUCONV_CHECK(n == (int)strlen(want) && strcmp(got, want) == 0,
+                   "tier %d itoa %" PRId64 " radix %u: \"%s\", want \"%s\"",
+                   tiers[i], s, radix, got, want);
+      int64_t sback;
+      NUCONV_CHECK(nuconv_do_atoi(&sback, want, radix, 0) == NUCONV_OK
+                   && sback == s, "tier %d atoi \"%s\" radix %u", tiers[i],
+                   want, radix);
+    }
+  }
+}
+
+/* Text just past each limit must overflow; the same digits behind leading
+   zeros must not. */
+static void check_limits(unsigned radix)
+{
+  char text[80];
+  char padded[100];
+  for (int i = 0; i < ntiers; ++i) {
+    nuconv_set_tier(tiers[i]);
+    uint64_t u;
+    int64_t s;
+    ref_format(text, UINT64_MAX, false, radix, lower);
+    memset(padded, '0', 19);
+    strcpy(padded + 19, text);
+    NUCONV_CHECK(nuconv_do_atou(&u, padded, radix, 0) == NUCONV_OK
+                 && u == UINT64_MAX, "tier %d \"%s\" radix %u", tiers[i],
+                 padded, radix);
+    ref_increment(text, radix);
+    NUCONV_CHECK(nuconv_do_atou(&u, text, radix, 0) == NUCONV_WARN_OVERFLOW,
+                 "tier %d \"%s\" radix %u", tiers[i], text, radix);
+
+    ref_format(text, (uint64_t)INT64_MAX, false, radix, lower);
+    NUCONV_CHECK(nuconv_do_atoi(&s, text, radix, 0) == NUCONV_OK
+                 && s == INT64_MAX, "tier %d \"%s\" radix %u", tiers[i],
+                 text, radix);
+    ref_increment(text, radix);
+    NUCONV_CHECK(nuconv_do_atoi(&s, text, radix, 0) == NUCONV_WARN_OVERFLOW,
+                 "tier %d \"%s\" radix %u", tiers[i], text, radix);
+
+    ref_format(text, (uint64_t)INT64_MAX + 1, true, radix, lower);
+    NUCONV_CHECK(nuconv_do_atoi(&s, text, radix, 0) == NUCONV_OK
+                 && s == INT64_MIN, "tier %d \"%s\" radix %u", tiers[i],
+                 text, radix);
+    ref_increment(text, radix);
+    NUCONV_CHECK(nuconv_do_atoi(&s, text, radix, 0) == NUCONV_WARN_OVERFLOW,
+                 "tier %d \"%s\" radix %u", tiers[i], text, radix);
+  }
+}
+
+int main(void)
+{
+  static const unsigned radixes[] = {2, 4, 8, 16, 32};
+  ntiers = nuconv_test_tiers(tiers);
+  for (size_t r = 0; r < sizeof(radixes) / sizeof(*radixes); ++r) {
+    const unsigned radix = radixes[r];
+    for (unsigned k = 0; k < 64; ++k) {
+      const uint64_t p = (uint64_t)1 << k;
+      check_value(p - 1, radix);
+      check_value(p, radix);
+      check_value(p + 1, radix);
+      check_value(0 - p, radix);
+    }
+    check_value(UINT64_MAX, radix);
+    for (int iter = 0; iter < 20000; ++iter) {
+      check_value(nuconv_test_rand() >> (nuconv_test_rand() % 64), radix);
+    }
+    check_limits(radix);
+  }
+  return nuconv_test_result("pow2");
+}
@@ -0,0 +1,140 @@
+#include "nuconv_test.h"
+
+#define MAX_FIELDS (64)
+
+static const unsigned radixes[] = {2, 10, 16, 36};
+
+/* Parse buf through the stream API, cut at random places into chunks and
+   fed with a small random capacity so that feeds also stop on count. */
+static size_t stream_parse(int64_t* dst, int* status, const char* buf,
+                           size_t len, const char* delims, unsigned radix,
+                           bool sig)
+{
+  struct nuconv_stream s;
+  nuconv_stream_init(&s, delims, radix, 0);
+  size_t n = 0;
+  size_t pos = 0;
+  while (pos < len) {
+    size_t chunk = (size_t)(nuconv_test_rand() % (len - pos + 1));
+    const char* ptr = buf + pos;
+    const char* end = ptr + chunk;
+    do {
+      size_t count = 1 + (size_t)(nuconv_test_rand() % 3);
+      if (count > MAX_FIELDS - n) {
+        count = MAX_FIELDS - n;
+      }
+      if (sig) {
+        nuconv_stream_feedi(&s, dst + n, status + n, &count, ptr, end, &ptr);
+      } else {
+        nuconv_stream_feedu(&s, (uint64_t*)dst + n, status + n, &count, ptr,
+                            end, &ptr);
+      }
+      n += count;
+    } while (ptr != end);
+    pos += chunk;
+  }
+  size_t count;
+  status[n] = sig
+    ? nuconv_stream_finishi(&s, dst + n, &count)
+    : nuconv_stream_finishu(&s, (uint64_t*)dst + n, &count);
+  return n + count;
+}
+
+static void check_split(const char* buf, size_t len, const char* delims,
+                        unsigned radix, bool sig)
+{
+  int64_t want[MAX_FIELDS + 1];
+  int want_status[MAX_FIELDS + 1];
+  int64_t got[MAX_FIELDS + 1];
+  int got_status[MAX_FIELDS + 1];
+  size_t nwant = MAX_FIELDS;
+  if (sig) {
+    nuconv_do_atoi_bulk(want, want_status, &nwant, buf, buf + len, NULL,
+                        delims, radix, 0);
+  } else {
+    nuconv_do_atou_bulk((uint64_t*)want, want_status, &nwant, buf, buf + len,
+                        NULL, delims, radix, 0);
+  }
+  const size_t ngot = stream_parse(got, got_status, buf, len, delims, radix,
+                                   sig);
+  NUCONV_CHECK(ngot == nwant, "\"%.*s\" radix %u: %zu fields, want %zu",
+               (int)len, buf, radix, ngot, nwant);
+  for (size_t i = 0; i < nwant && i < ngot; ++i) {
+    NUCONV_CHECK(got[i] == want[i] && got_status[i] == want_status[i],
+                 "\"%.*s\" radix %u field %zu: %" PRId64 "/%d, want %"
+                 PRId64 "/%d", (int)len, buf, radix, i, got[i],
+                 got_status[i], want[i], want_status[i]);
+  }
+}
+
+static void test_random_splits(void)
+{
+  static const char alphabet[] = "0123456789abcfz-+_ ,;,x9999";
+  char buf[48];
+  for (int iter = 0; iter < 200000; ++iter) {
+    const size_t len = (size_t)(nuconv_test_rand() % sizeof(buf));
+    for (size_t i = 0; i < len; ++i) {
+      buf[i] = alphabet[nuconv_test_rand() % (sizeof(alphabet) - 1)];
+    }
+    const unsigned radix = radixes[nuconv_test_rand() % 4];
+    check_split(buf, len, iter & 2 ? ",;" : ",", radix, iter & 1);
+  }
+}
+
+static void test_trailing_field(void)
+{
+  struct nuconv_stream s;
+  int64_t v = 7;
+  size_t count;
+  int status;
+
+  nuconv_stream_init(&s, ",", 10, 0);
+  count = 4;
+  nuconv_stream_feedi(&s, &v, &status, &count, "1,", NULL, NULL);
+  NUCONV_CHECK(count == 1 && v == 1, "count %zu", count);
+  v = 7;
+  NUCONV_CHECK(nuconv_stream_finishi(&s, &v, &count) == NUCONV_OK
+               && count == 0 && v == 7, "count %zu", count);
+
+  /* A pending field of skip characters only is an empty field, not "no
+     field", as in nuconv_do_atoi_bulk. */
+  count = 4;
+  nuconv_stream_feedi(&s, &v, &status, &count, "1, ", NULL, NULL);
+  NUCONV_CHECK(nuconv_stream_finishi(&s, &v, &count) == -NUCONV_ERROR_EMPTY
+               && count == 1, "count %zu", count);
+
+  /* Overflow accumulated across feeds reports and wraps as nuconv_do_atoin
+     does on the joined text. */
+  int64_t want;
+  nuconv_do_atoin(&want, "-9223372036854775809", NULL, NULL, 10, 0);
+  count = 4;
+  nuconv_stream_feedi(&s, &v, &status, &count, "-92233720", NULL, NULL);
+  count = 4;
+  nuconv_stream_feedi(&s, &v, &status, &count, "36854775809", NULL, NULL);
+  NUCONV_CHECK(nuconv_stream_finishi(&s, &v, &count) == NUCONV_WARN_OVERFLOW
+               && count == 1 && v == want, "v %" PRId64, v);
+}
+
+static void test_bulk_null_end(void)
+{
+  int64_t a[8];
+  int64_t b[8];
+  size_t na = 8;
+  size_t nb = 8;
+  const char* sa;
+  const char* sb;
+  const char* str = "12, -3,,x,4";
+  const int ra = nuconv_do_atoi_bulk(a, NULL, &na, str, NULL, &sa, ",", 10, 0);
+  const int rb = nuconv_do_atoi_bulk(b, NULL, &nb, str, str + strlen(str), &sb,
+                                     ",", 10, 0);
+  NUCONV_CHECK(ra == rb && na == nb && sa == sb
+               && memcmp(a, b, na * sizeof(*a)) == 0, "%zu vs %zu", na, nb);
+}
+
+int main(void)
+{
+  test_random_splits();
+  test_trailing_field();
+  test_bulk_null_end();
+  return nuconv_test_result("stream");
+}
@@ -0,0 +1,239 @@
+#include "nuconv_test.h"
+
+#include <stdlib.h>
+
+/* Runs the parsers and formatters under every tier the CPU supports and
+   compares each result with the scalar tier's. */
+
+static int tiers[NUCONV_TIER_AVX2];
+static int ntiers;
+
+struct parse_result {
+  int r;
+  uint64_t v;
+  const char* stop;
+};
+
+static void parse(struct parse_result* out, int tier, const char* begin,
+                  const char* end, unsigned radix, bool sig)
+{
+  nuconv_set_tier(tier);
+  out->v = 0x5A5A5A5A5A5A5A5Aull;
+  if (sig) {
+    int64_t v = (int64_t)out->v;
+    out->r = nuconv_do_atoin(&v, begin, end, &out->stop, radix, 0);
+    out->v = (uint64_t)v;
+  } else {
+    out->r = nuconv_do_atoun(&out->v, begin, end, &out->stop, radix, 0);
+  }
+}
+
+/* [begin, end) as printable text for failure messages. */
+static const char* show(const char* begin, const char* end)
+{
+  static char buf[256];
+  size_t n = 0;
+  for (const char* p = begin; (end != NULL ? p != end : *p != '\0')
+                              && n < sizeof(buf) - 5; ++p) {
+    n += (size_t)snprintf(buf + n, sizeof(buf) - n,
+                          *p >= 0x20 && *p < 0x7F ? "%c" : "\\x%02x",
+                          (unsigned char)*p);
+  }
+  buf[n] = '\0';
+  return buf;
+}
+
+static void check_parse(const char* begin, const char* end, unsigned radix)
+{
+  for (int sig = 0; sig < 2; ++sig) {
+    struct parse_result want;
+    parse(&want, NUCONV_TIER_SCALAR, begin, end, radix, sig);
+    for (int i = 0; i < ntiers; ++i) {
+      struct parse_result got;
+      parse(&got, tiers[i], begin, end, radix, sig);
+      NUCONV_CHECK(got.r == want.r && got.v == want.v
+                   && got.stop == want.stop,
+                   "tier %d %s \"%s\" radix %u: %d/%" PRIx64 "/+%td, want "
+                   "%d/%" PRIx64 "/+%td", tiers[i], sig ? "atoin" : "atoun",
+                   show(begin, end), radix, got.r, got.v, got.stop - begin,
+                   want.r, want.v, want.stop - begin);
+    }
+  }
+}
+
+/* Digit runs are mostly sized around the 8/16/32-byte kernel widths. */
+static unsigned random_run(void)
+{
+  static const unsigned lens[] = {1, 7, 8, 9, 15, 16, 17, 19, 20, 21,
+                                  31, 32, 33, 40};
+  return nuconv_test_rand() % 4 == 0
+    ? (unsigned)(nuconv_test_rand() % 48)
+    : lens[nuconv_test_rand() % (sizeof(lens) / sizeof(*lens))];
+}
+
+/* One or two digit runs in radix with occasional signs, skip characters and
+   invalid bytes; leading zeros keep some long runs below the overflow. */
+static size_t random_text(char* buf, unsigned radix)
+{
+  static const char digits[] = "0123456789abcdefABCDEF";
+  static const char other[] = "-+_ \t,.xg:\x80\xff";
+  size_t n = 0;
+  if (nuconv_test_rand() % 4 == 0) {
+    buf[n++] = other[nuconv_test_rand() % 5];
+  }
+  const unsigned runs = 1 + (unsigned)(nuconv_test_rand() % 2);
+  for (unsigned run = 0; run < runs; ++run) {
+    const unsigned len = random_run();
+    const unsigned zeros = nuconv_test_rand() % 2 ? len / 2 : 0;
+    for (unsigned i = 0; i < len; ++i) {
+      buf[n++] = i < zeros ? '0'
+        : radix == 16 ? digits[nuconv_test_rand() % 22]
+        : (char)('0' + nuconv_test_rand() % radix);
+    }
+    if (nuconv_test_rand() % 2) {
+      buf[n++] = other[nuconv_test_rand() % (sizeof(other) - 1)];
+    }
+  }
+  return n;
+}
+
+static void test_parse_random(void)
+{
+  static const unsigned radixes[] = {10, 16, 8, 2, 36};
+  char buf[256];
+  for (int iter = 0; iter < 200000; ++iter) {
+    const unsigned radix = radixes[nuconv_test_rand() % 4 != 0
+                                   ? nuconv_test_rand() % 2
+                                   : 2 + nuconv_test_rand() % 3];
+    const size_t off = (size_t)(nuconv_test_rand() % 32);
+    const size_t len = random_text(buf + off, radix);
+    buf[off + len] = '\0';
+    check_parse(buf + off, buf + off + len, radix);
+    check_parse(buf + off, NULL, radix);
+  }
+}
+
+static void test_parse_bounds(void)
+{
+  static const char* const texts[] = {
+    "0", "-0", "", "-", "+", "_",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+    "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+    "99999999999999999999", "00000000000000000000000000000000001",
+    "1234567890123456", "12345678901234567", "1234567890123456789012345678901",
+    "12345678901234567890123456789012", "ffffffffffffffff",
+    "10000000000000000", "0000000000000000ffffffffffffffff",
+    "7fffffffffffffff", "-8000000000000000", "-8000000000000001",
+    "FfFfFfFfFfFfFfFf0", "123_456_789_012_345_678",
+  };
+  for (size_t i = 0; i < sizeof(texts) / sizeof(*texts); ++i) {
+    const size_t len = strlen(texts[i]);
+    check_parse(texts[i], texts[i] + len, 10);
+    check_parse(texts[i], NULL, 10);
+    check_parse(texts[i], texts[i] + len, 16);
+    check_parse(texts[i], NULL, 16);
+  }
+}
+
+/* NUL-terminated text ending at the last byte before an unmapped page, and
+   the same text bounded by end with no NUL at all: a kernel loading past
+   either faults. */
+static void test_parse_page_end(void)
+{
+  char* const guard = nuconv_test_guard_page(256);
+  if (guard == NULL) {
+    return;
+  }
+  char buf[256];
+  for (int iter = 0; iter < 20000; ++iter) {
+    const unsigned radix = nuconv_test_rand() % 2 ? 10 : 16;
+    const size_t len = random_text(buf, radix);
+    char* const text = guard - len;
+    memcpy(text, buf, len);
+    check_parse(text, guard, radix);
+    memmove(text - 1, text, len);
+    guard[-1] = '\0';
+    check_parse(text - 1, NULL, radix);
+  }
+}
+
+static void test_format(void)
+{
+  char want[80];
+  char got[80];
+  for (int iter = 0; iter < 200000; ++iter) {
+    const uint64_t v = nuconv_test_rand() >> (nuconv_test_rand() % 64);
+    const unsigned radix = nuconv_test_rand() % 2
+      ? 16
+      : 2 + (unsigned)(nuconv_test_rand() % 35);
+    const int flags = nuconv_test_rand() % 2 ? NUCONV_FLAG_UPPERCASE : 0;
+    const bool sig = nuconv_test_rand() % 2;
+    nuconv_set_tier(NUCONV_TIER_SCALAR);
+    const int wn = sig ? nuconv_do_itoa((int64_t)v, want, radix, flags)
+                       : nuconv_do_utoa(v, want, radix, flags);
+    for (int i = 0; i < ntiers; ++i) {
+      nuconv_set_tier(tiers[i]);
+      const int gn = sig ? nuconv_do_itoa((int64_t)v, got, radix, flags)
+                         : nuconv_do_utoa(v, got, radix, flags);
+      NUCONV_CHECK(gn == wn && strcmp(got, want) == 0,
+                   "tier %d %s %" PRIx64 " radix %u: \"%s\", want \"%s\"",
+                   tiers[i], sig ? "itoa" : "utoa", v, radix, got, want);
+    }
+  }
+  for (int iter = 0; iter < 20000; ++iter) {
+    const unsigned v = (unsigned)nuconv_test_rand();
+    const int radix = nuconv_test_rand() % 2 ? 16 : 10;
+    const bool sig = nuconv_test_rand() % 2;
+    nuconv_set_tier(NUCONV_TIER_SCALAR);
+    if (sig) {
+      nuconv_itoa((int)v, want, radix);
+    } else {
+      nuconv_utoa(v, want, radix);
+    }
+    for (int i = 0; i < ntiers; ++i) {
+      nuconv_set_tier(tiers[i]);
+      if (sig) {
+        nuconv_itoa((int)v, got, radix);
+      } else {
+        nuconv_utoa(v, got, radix);
+      }
+      NUCONV_CHECK(strcmp(got, want) == 0,
+                   "tier %d %s %x radix %d: \"%s\", want \"%s\"", tiers[i],
+                   sig ? "itoa" : "utoa", v, radix, got, want);
+    }
+  }
+}
+
+/* Run with NUCONV_TIER set in the environment: the tier selected at load
+   must be expect ("best" or a tier number, clamped to the CPU's). */
+static int test_env(const char* expect)
+{
+  const int initial = nuconv_get_tier();
+  const int best = nuconv_set_tier(NUCONV_TIER_BEST);
+  int want = best;
+  if (strcmp(expect, "best") != 0) {
+    want = atoi(expect) < best ? atoi(expect) : best;
+  }
+  NUCONV_CHECK(initial == want, "NUCONV_TIER=\"%s\": tier %d, want %d",
+               getenv("NUCONV_TIER"), initial, want);
+  return nuconv_test_result("tier env");
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1) {
+    return test_env(argv[1]);
+  }
+  for (int tier = NUCONV_TIER_SCALAR + 1; tier <= NUCONV_TIER_AVX2; ++tier) {
+    if (nuconv_set_tier(tier) == tier) {
+      tiers[ntiers++] = tier;
+    }
+  }
+  printf("tier: comparing %d tier%s with scalar\n", ntiers,
+         ntiers == 1 ? "" : "s");
+  test_parse_random();
+  test_parse_bounds();
+  test_parse_page_end();
+  test_format();
+  return nuconv_test_result("tier");
+}
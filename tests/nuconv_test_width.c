@@ -0,0 +1,214 @@
+#include "nuconv_test.h"
+
+/* Digits of mag in radix, with a leading '-' when neg. */
+static void ref_format(char* buf, uint64_t mag, bool neg, unsigned radix)
+{
+  char tmp[72];
+  size_t n = 0;
+  do {
+    tmp[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[mag % radix];
+    mag /= radix;
+  } while (mag != 0);
+  if (neg) {
+    *buf++ = '-';
+  }
+  while (n > 0) {
+    *buf++ = tmp[--n];
+  }
+  *buf = '\0';
+}
+
+/* Random text of one number in radix: an optional sign, up to 24 digits
+   (enough to overflow 64 bits in radix 10) and a few skip characters.
+   *mag receives its magnitude and *big whether that exceeds 64 bits. */
+static size_t random_number(char* buf, unsigned radix, bool sig, bool* neg,
+                            uint64_t* mag, bool* big)
+{
+  size_t n = 0;
+  *neg = sig && nuconv_test_rand() % 2;
+  *mag = 0;
+  *big = false;
+  if (*neg) {
+    buf[n++] = '-';
+  }
+  const unsigned digits = 1 + (unsigned)(nuconv_test_rand() % 24);
+  for (unsigned i = 0; i < digits; ++i) {
+    if (nuconv_test_rand() % 8 == 0) {
+      buf[n++] = "_+ "[nuconv_test_rand() % 3];
+    }
+    const unsigned d = (unsigned)(nuconv_test_rand() % radix);
+    buf[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[d];
+    if (*big || *mag > (UINT64_MAX - d) / radix) {
+      *big = true;
+    } else {
+      *mag = *mag * radix + d;
+    }
+  }
+  buf[n] = '\0';
+  return n;
+}
+
+/* Parse random numbers at every width and compare with the exact value
+   saturated to the width, then check the boundaries of each type format as
+   the reference and parse back. */
+#define TEST_SIGNED(bits)                                                     \
+static void test_i##bits(void)                                                \
+{                                                                             \
+  const uint64_t max = (uint64_t)INT##bits##_MAX;                             \
+  char buf[80];                                                               \
+  char ref[80];                                                               \
+  for (int iter = 0; iter < 100000; ++iter) {                                 \
+    const unsigned radix = 2 + (unsigned)(nuconv_test_rand() % 35);           \
+    bool neg;                                                                 \
+    bool big;                                                                 \
+    uint64_t mag;                                                             \
+    const size_t len = random_number(buf, radix, true, &neg, &mag, &big);     \
+    const bool over = big || mag > max + neg;                                 \
+    const uint64_t sat = over ? max + neg : mag;                              \
+    const int##bits##_t want = (int##bits##_t)(neg ? 0 - sat : sat);          \
+    int##bits##_t got;                                                        \
+    const char* stop;                                                         \
+    const int r = nuconv_do_atoi##bits(&got, buf, buf + len, &stop, radix,    \
+                                       0);                                    \
+    NUCONV_CHECK(got == want && stop == buf + len                             \
+                 && r == (over ? NUCONV_WARN_OVERFLOW : NUCONV_OK),           \
+                 "\"%s\" radix %u: %" PRId64 "/%d, want %" PRId64,            \
+                 buf, radix, (int64_t)got, r, (int64_t)want);                 \
+  }                                                                           \
+  const int##bits##_t edges[] = {INT##bits##_MIN, INT##bits##_MIN + 1, -1, 0, \
+                                 1, INT##bits##_MAX - 1, INT##bits##_MAX};    \
+  for (unsigned radix = 2; radix <= 36; ++radix) {                            \
+    for (size_t i = 0; i < sizeof(edges) / sizeof(*edges); ++i) {             \
+      const int##bits##_t v = edges[i];                                       \
+      const int len = nuconv_do_itoa##bits(v, buf, radix, 0);                 \
+      ref_format(ref, v < 0 ? 0 - (uint64_t)v : (uint64_t)v, v < 0, radix);   \
+      NUCONV_CHECK(strcmp(buf, ref) == 0 && len == (int)strlen(ref),          \
+                   "%" PRId64 " radix %u: \"%s\", want \"%s\"",               \
+                   (int64_t)v, radix, buf, ref);                              \
+      int##bits##_t back;                                                     \
+      NUCONV_CHECK(nuconv_do_atoi##bits(&back, buf, NULL, NULL, radix, 0)     \
+                   == NUCONV_OK && back == v, "\"%s\" radix %u", buf, radix); \
+    }                                                                         \
+    /* One past either end saturates. */                                      \
+    int##bits##_t got;                                                        \
+    ref_format(ref, max + 2, true, radix);                                    \
+    NUCONV_CHECK(nuconv_do_atoi##bits(&got, ref, NULL, NULL, radix, 0)        \
+                 == NUCONV_WARN_OVERFLOW && got == INT##bits##_MIN,           \
+                 "\"%s\" radix %u", ref, radix);                              \
+    ref_format(ref, max + 1, false, radix);                                   \
+    NUCONV_CHECK(nuconv_do_atoi##bits(&got, ref, NULL, NULL, radix, 0)        \
+                 == NUCONV_WARN_OVERFLOW && got == INT##bits##_MAX,           \
+                 "\"%s\" radix %u", ref, radix);                              \
+  }                                                                           \
+}
+
+#define TEST_UNSIGNED(bits)                                                   \
+static void test_u##bits(void)                                                \
+{                                                                             \
+  const uint64_t max = (uint64_t)UINT##bits##_MAX;                            \
+  char buf[80];                                                               \
+  char ref[80];                                                               \
+  for (int iter = 0; iter < 100000; ++iter) {                                 \
+    const unsigned radix = 2 + (unsigned)(nuconv_test_rand() % 35);           \
+    bool neg;                                                                 \
+    bool big;                                                                 \
+    uint64_t mag;                                                             \
+    const size_t len = random_number(buf, radix, false, &neg, &mag, &big);    \
+    const bool over = big || mag > max;                                       \
+    const uint##bits##_t want = (uint##bits##_t)(over ? max : mag);           \
+    uint##bits##_t got;                                                       \
+    const char* stop;                                                         \
+    const int r = nuconv_do_atou##bits(&got, buf, buf + len, &stop, radix,    \
+                                       0);                                    \
+    NUCONV_CHECK(got == want && stop == buf + len                             \
+                 && r == (over ? NUCONV_WARN_OVERFLOW : NUCONV_OK),           \
+                 "\"%s\" radix %u: %" PRIu64 "/%d, want %" PRIu64,            \
+                 buf, radix, (uint64_t)got, r, (uint64_t)want);               \
+  }                                                                           \
+  const uint##bits##_t edges[] = {0, 1, UINT##bits##_MAX - 1,                 \
+                                  UINT##bits##_MAX};                          \
+  for (unsigned radix = 2; radix <= 36; ++radix) {                            \
+    for (size_t i = 0; i < sizeof(edges) / sizeof(*edges); ++i) {             \
+      const uint##bits##_t v = edges[i];                                      \
+      const int len = nuconv_do_utoa##bits(v, buf, radix, 0);                 \
+      ref_format(ref, v, false, radix);                                       \
+      NUCONV_CHECK(strcmp(buf, ref) == 0 && len == (int)strlen(ref),          \
+                   "%" PRIu64 " radix %u: \"%s\", want \"%s\"",               \
+                   (uint64_t)v, radix, buf, ref);                             \
+      uint##bits##_t back;                                                    \
+      NUCONV_CHECK(nuconv_do_atou##bits(&back, buf, NULL, NULL, radix, 0)     \
+                   == NUCONV_OK && back == v, "\"%s\" radix %u", buf, radix); \
+    }                                                                         \
+    if (bits < 64) {                                                          \
+      uint##bits##_t got;                                                     \
+      ref_format(ref, max + 1, false, radix);                                 \
+      NUCONV_CHECK(nuconv_do_atou##bits(&got, ref, NULL, NULL, radix, 0)      \
+                   == NUCONV_WARN_OVERFLOW && got == UINT##bits##_MAX,        \
+                   "\"%s\" radix %u", ref, radix);                            \
+    }                                                                         \
+  }                                                                           \
+}
+
+TEST_SIGNED(8)
+TEST_SIGNED(16)
+TEST_SIGNED(32)
+TEST_SIGNED(64)
+TEST_UNSIGNED(8)
+TEST_UNSIGNED(16)
+TEST_UNSIGNED(32)
+TEST_UNSIGNED(64)
+
+/* The 64-bit parsers without a width keep the low 64 bits of an
+   out-of-range value instead of saturating. */
+static void test_wrap(void)
+{
+  char buf[80];
+  for (int iter = 0; iter < 100000; ++iter) {
+    const unsigned radix = 2 + (unsigned)(nuconv_test_rand() % 35);
+    const bool neg = nuconv_test_rand() % 2;
+    const unsigned digits = 1 + (unsigned)(nuconv_test_rand() % 40);
+    uint64_t low = 0;
+    bool big = false;
+    size_t n = 0;
+    if (neg) {
+      buf[n++] = '-';
+    }
+    for (unsigned i = 0; i < digits; ++i) {
+      const unsigned d = (unsigned)(nuconv_test_rand() % radix);
+      buf[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[d];
+      big |= __builtin_mul_overflow(low, radix, &low);
+      big |= __builtin_add_overflow(low, d, &low);
+    }
+    buf[n] = '\0';
+    const int64_t want = (int64_t)(neg ? 0 - low : low);
+    const int wr = big || low > (uint64_t)INT64_MAX + neg
+      ? NUCONV_WARN_OVERFLOW
+      : NUCONV_OK;
+    int64_t got;
+    NUCONV_CHECK(nuconv_do_atoi(&got, buf, radix, 0) == wr && got == want,
+                 "atoi \"%s\" radix %u: %" PRId64 ", want %" PRId64, buf,
+                 radix, got, want);
+    NUCONV_CHECK(nuconv_do_atoin(&got, buf, buf + n, NULL, radix, 0) == wr
+                 && got == want, "atoin \"%s\" radix %u: %" PRId64
+                 ", want %" PRId64, buf, radix, got, want);
+    uint64_t ugot;
+    NUCONV_CHECK(nuconv_do_atoun(&ugot, buf + neg, buf + n, NULL, radix, 0)
+                 == (big ? NUCONV_WARN_OVERFLOW : NUCONV_OK) && ugot == low,
+                 "atoun \"%s\" radix %u: %" PRIu64 ", want %" PRIu64,
+                 buf + neg, radix, ugot, low);
+  }
+}
+
+int main(void)
+{
+  test_wrap();
+  test_i8();
+  test_i16();
+  test_i32();
+  test_i64();
+  test_u8();
+  test_u16();
+  test_u32();
+  test_u64();
+  return nuconv_test_result("width");
+}